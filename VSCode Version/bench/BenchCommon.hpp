@@ -0,0 +1,22 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+
+// small helpers shared by the bench tools (not part of the game build)
+
+inline double benchNow()
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+// runs fn once and returns how long it took in milliseconds
+template <typename Fn>
+inline double benchMs(Fn &&fn)
+{
+    double t0 = benchNow();
+    fn();
+    return (benchNow() - t0) * 1000.0;
+}
+
+inline double toMiB(size_t bytes) { return bytes / (1024.0 * 1024.0); }
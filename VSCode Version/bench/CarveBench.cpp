@@ -0,0 +1,101 @@
+// Carving benchmark: the old per-tile CheckCollisionCircleRec scan against cached circle spans,
+// and Tilemap::carveCircle one at a time against one carveCircles batch.
+// Checks the spans carve exactly the tiles the old scan does (centres snapped to 1/8 tile).
+// usage: CarveBench [size]
+#include "BenchCommon.hpp"
+#include "Tilemap.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// the scan carveCircle used to do
+static void carveScan(std::vector<uint8_t> &cells, int W, int H, Vector2 c, float r)
+{
+    const float T = (float)Tilemap::TILE_SIZE;
+    int minTx = std::max(0, (int)floorf((c.x - r) / T)), maxTx = std::min(W - 1, (int)floorf((c.x + r) / T));
+    int minTy = std::max(0, (int)floorf((c.y - r) / T)), maxTy = std::min(H - 1, (int)floorf((c.y + r) / T));
+    for (int ty = minTy; ty <= maxTy; ++ty)
+        for (int tx = minTx; tx <= maxTx; ++tx)
+            if (CheckCollisionCircleRec(c, r, Rectangle{tx * T, ty * T, T, T}))
+                cells[(size_t)ty * W + tx] = 0;
+}
+
+static void carveSpans(CircleStampCache &cache, std::vector<uint8_t> &cells, int W, int H, Vector2 c, float r)
+{
+    int cx, cy, sx, sy;
+    CircleStampCache::snap(c.x, Tilemap::TILE_SIZE, cx, sx);
+    CircleStampCache::snap(c.y, Tilemap::TILE_SIZE, cy, sy);
+    const CircleSpans &s = cache.get(r, Tilemap::TILE_SIZE, sx, sy);
+    for (int i = 0; i < s.rows(); ++i)
+    {
+        int ty = cy + s.rowMin + i;
+        if (ty < 0 || ty >= H)
+            continue;
+        int x0 = std::max(0, cx + s.x0[i]), x1 = std::min(W - 1, cx + s.x1[i]);
+        for (int tx = x0; tx <= x1; ++tx)
+            cells[(size_t)ty * W + tx] = 0;
+    }
+}
+
+// the old scan only agrees with the spans for snapped centres
+static Vector2 snapped(Vector2 p)
+{
+    const float step = (float)Tilemap::TILE_SIZE / CircleStampCache::SUBTILE;
+    return {floorf(p.x / step + 0.5f) * step, floorf(p.y / step + 0.5f) * step};
+}
+
+int main(int argc, char **argv)
+{
+    int n = (argc > 1) ? atoi(argv[1]) : 1024;
+    const int CARVES = 20000;
+
+    Tilemap base(n, n);
+    base.generateCave(11, 45, 5);
+    std::vector<uint8_t> cells((size_t)n * n);
+    for (int y = 0; y < n; ++y)
+        for (int x = 0; x < n; ++x)
+            cells[(size_t)y * n + x] = base.isWall(x, y);
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> coord(0.0f, (float)n * Tilemap::TILE_SIZE);
+
+    printf("%-8s %12s %12s %14s %14s %s\n", "radius", "scan ns", "spans ns", "carveCircle ns", "batch ns", "match");
+    for (float radius : {48.0f, 50.0f, 96.0f})
+    {
+        std::vector<Vector2> pts(CARVES);
+        for (auto &p : pts)
+            p = snapped({coord(rng), coord(rng)});
+
+        std::vector<uint8_t> a = cells, b = cells;
+        CircleStampCache cache;
+        double scanMs = benchMs([&]
+                                { for (auto &p : pts) carveScan(a, n, n, p, radius); });
+        double spanMs = benchMs([&]
+                                { for (auto &p : pts) carveSpans(cache, b, n, n, p, radius); });
+        bool match = (a == b);
+
+        // through the map, floor index and clearance upkeep included
+        Tilemap one = base, batch = base;
+        double oneMs = benchMs([&]
+                               { for (auto &p : pts) one.carveCircle(p, radius, false); });
+        std::vector<CarveStamp> stamps;
+        for (auto &p : pts)
+            stamps.push_back({p, radius, false});
+        double batchMs = benchMs([&]
+                                 { batch.carveCircles(stamps.data(), (int)stamps.size()); });
+        for (int y = 0; y < n && match; ++y)
+            for (int x = 0; x < n; ++x)
+                if (one.isWall(x, y) != (a[(size_t)y * n + x] != 0) || batch.isWall(x, y) != one.isWall(x, y))
+                {
+                    match = false;
+                    break;
+                }
+
+        printf("%-8.0f %12.1f %12.1f %14.1f %14.1f %s\n", radius, scanMs * 1e6 / CARVES, spanMs * 1e6 / CARVES,
+               oneMs * 1e6 / CARVES, batchMs * 1e6 / CARVES, match ? "yes" : "NO");
+        if (!match)
+            return 1;
+    }
+    return 0;
+}
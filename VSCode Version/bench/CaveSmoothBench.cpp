@@ -0,0 +1,91 @@
+// Cave smoothing benchmark: scalar neighbour counting (the old generateCave loop) against the
+// packed bitwise kernel, single and multi threaded. Also checks the outputs are bit-identical.
+// usage: CaveSmoothBench [size ...]
+#include "BenchCommon.hpp"
+#include "BitGrid.hpp"
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+// the per-cell rule generateCave used before the packed kernel
+static void smoothScalar(const std::vector<uint8_t> &src, std::vector<uint8_t> &dst, int W, int H)
+{
+    for (int y = 0; y < H; ++y)
+    {
+        for (int x = 0; x < W; ++x)
+        {
+            if (x == 0 || y == 0 || x == W - 1 || y == H - 1)
+            {
+                dst[(size_t)y * W + x] = 1;
+                continue;
+            }
+            int n = 0;
+            for (int dy = -1; dy <= 1; ++dy)
+                for (int dx = -1; dx <= 1; ++dx)
+                    if ((dx || dy) && src[(size_t)(y + dy) * W + x + dx] == 1)
+                        n++;
+            uint8_t cur = src[(size_t)y * W + x];
+            dst[(size_t)y * W + x] = (n > 4) ? 1 : (n < 4 ? 0 : cur);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<int> sizes = {100, 1024, 4096};
+    if (argc > 1)
+    {
+        sizes.clear();
+        for (int i = 1; i < argc; ++i)
+            sizes.push_back(atoi(argv[i]));
+    }
+    const int STEPS = 5;
+    int hw = (int)std::max(1u, std::thread::hardware_concurrency());
+
+    printf("%-6s %12s %12s %12s %10s %s\n", "size", "scalar ms", "bits ms", "bits xN ms", "speedup", "identical");
+    for (int n : sizes)
+    {
+        // random fill the way generateCave does it
+        std::mt19937 rng(1234);
+        std::uniform_int_distribution<int> d100(0, 99);
+        std::vector<uint8_t> base((size_t)n * n);
+        for (int y = 0; y < n; ++y)
+            for (int x = 0; x < n; ++x)
+                base[(size_t)y * n + x] = (x == 0 || y == 0 || x == n - 1 || y == n - 1) ? 1 : (d100(rng) < 45);
+
+        std::vector<uint8_t> a = base, b(base.size());
+        double scalarMs = benchMs([&]
+                                  {
+            for (int s = 0; s < STEPS; ++s)
+            {
+                smoothScalar(a, b, n, n);
+                a.swap(b);
+            } });
+
+        auto runBits = [&](int threads, std::vector<uint8_t> &out)
+        {
+            BitGrid cur, next;
+            cur.fromBytes(base.data(), n, n);
+            double ms = benchMs([&]
+                                {
+                for (int s = 0; s < STEPS; ++s)
+                {
+                    smoothCaveBits(cur, next, threads);
+                    std::swap(cur, next);
+                } });
+            out.resize(base.size());
+            cur.toBytes(out.data());
+            return ms;
+        };
+        std::vector<uint8_t> single, multi;
+        double bitsMs = runBits(1, single);
+        double bitsMtMs = runBits(hw, multi);
+
+        bool same = (single == a) && (multi == a);
+        printf("%-6d %12.2f %12.2f %12.2f %9.1fx %s\n", n, scalarMs, bitsMs, bitsMtMs, scalarMs / bitsMs, same ? "yes" : "NO");
+        if (!same)
+            return 1;
+    }
+    return 0;
+}
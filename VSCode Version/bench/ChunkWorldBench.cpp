@@ -0,0 +1,87 @@
+// ChunkWorld streaming benchmark: walks a player a long way in a straight line and checks that
+// memory stays flat, then times queries that cross chunk borders and checks carved chunks page
+// out and back in without leaving files behind
+// usage: ChunkWorldBench [tiles to walk]
+#include "BenchCommon.hpp"
+#include "ChunkWorld.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static bool fileExists(const std::string &path)
+{
+    FILE *f = fopen(path.c_str(), "rb");
+    if (f)
+        fclose(f);
+    return f != nullptr;
+}
+
+int main(int argc, char **argv)
+{
+    int walkTiles = (argc > 1) ? atoi(argv[1]) : 20000;
+
+    ChunkWorld world(1337);
+    world.setStreamRadius(2, 3);
+
+    printf("%-10s %10s %12s %12s\n", "walked", "chunks", "memory KiB", "update ms");
+    Vector2 p{0.5f * ChunkWorld::TILE_SIZE, 0.5f * ChunkWorld::TILE_SIZE};
+    double totalUpdateMs = 0.0;
+    int updates = 0;
+    for (int t = 0; t <= walkTiles; t += 4)
+    {
+        p.x = (t + 0.5f) * ChunkWorld::TILE_SIZE;
+        p.y = (t * 0.5f + 0.5f) * ChunkWorld::TILE_SIZE;
+        double ms = benchMs([&]
+                            { world.update(p); });
+        totalUpdateMs += ms;
+        updates++;
+        if (t % (walkTiles / 8 > 0 ? (walkTiles / 8) / 4 * 4 : 4) == 0)
+            printf("%-10d %10d %12.1f %12.3f\n", t, world.loadedChunkCount(), world.memoryBytes() / 1024.0, ms);
+    }
+    printf("mean update %.3f ms\n", totalUpdateMs / updates);
+
+    // queries around the player that cross chunk borders
+    int ptx, pty;
+    world.worldToTile(p, ptx, pty);
+    std::vector<Vector2> floors;
+    for (int y = pty - 100; y <= pty + 100 && floors.size() < 256; y += 7)
+        for (int x = ptx - 100; x <= ptx + 100 && floors.size() < 256; x += 5)
+            if (!world.isWall(x, y))
+                floors.push_back(world.tileToWorldCenter(x, y));
+
+    std::vector<Vector2> path;
+    int found = 0, visible = 0, queries = (int)floors.size() / 2;
+    double pathMs = benchMs([&]
+                            {
+        for (int q = 0; q < queries; ++q)
+            found += world.findPath(floors[q], floors[q + queries], path); });
+    double losMs = benchMs([&]
+                           {
+        for (int q = 0; q < queries; ++q)
+            visible += world.hasLineOfSight(floors[q], floors[q + queries]); });
+    printf("findPath %.3f ms/query (%d/%d found), hasLineOfSight %.2f us/query (%d visible)\n",
+           pathMs / queries, found, queries, losMs * 1000.0 / queries, visible);
+
+    // carve at the origin, walk away so it pages out, come back, walk away again and drop the world
+    const char *tmp = getenv("TMPDIR");
+    std::string dir = tmp ? tmp : ".";
+    std::string page = dir + "/chunk_7_0_0.bin";
+    bool pagedOut = false, restored = false, cleaned = false;
+    {
+        ChunkWorld paged(7);
+        paged.setPageDirectory(dir);
+        Vector2 home = paged.tileToWorldCenter(20, 20), away = paged.tileToWorldCenter(20 + 20 * ChunkWorld::CHUNK_SIZE, 20);
+        paged.update(home);
+        paged.carveCircle(home, 3.0f * ChunkWorld::TILE_SIZE);
+        paged.update(away);
+        pagedOut = fileExists(page);
+        paged.update(home);
+        restored = !paged.isWall(20, 20) && !fileExists(page);
+        paged.update(away);
+    }
+    cleaned = !fileExists(page);
+    printf("paging: written %s, read back %s, cleaned up %s\n", pagedOut ? "yes" : "no", restored ? "yes" : "no",
+           cleaned ? "yes" : "no");
+    return (pagedOut && restored && cleaned) ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+// Clearance map benchmark: full distance transform, the windowed update after a carve against
+// a full rebuild (results must match), and circle-vs-wall tests with and without the field.
+// usage: ClearanceBench [size ...]
+#include "BenchCommon.hpp"
+#include "Tilemap.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// the tile loop Bullet and Boulder used to run on every substep
+static bool circleHitsWallLoop(const Tilemap &map, Vector2 p, float radius)
+{
+    const int T = Tilemap::TILE_SIZE;
+    int minTx = (int)((p.x - radius) / T), minTy = (int)((p.y - radius) / T);
+    int maxTx = (int)((p.x + radius) / T), maxTy = (int)((p.y + radius) / T);
+    for (int ty = minTy; ty <= maxTy; ++ty)
+        for (int tx = minTx; tx <= maxTx; ++tx)
+            if (map.isWall(tx, ty) && CheckCollisionCircleRec(p, radius, Rectangle{(float)tx * T, (float)ty * T, (float)T, (float)T}))
+                return true;
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<int> sizes = {100, 1024, 4096};
+    if (argc > 1)
+    {
+        sizes.clear();
+        for (int i = 1; i < argc; ++i)
+            sizes.push_back(atoi(argv[i]));
+    }
+
+    for (int n : sizes)
+    {
+        Tilemap map(n, n);
+        map.generateCave(7, 45, 5);
+
+        // full transform on its own
+        ClearanceField full;
+        std::vector<uint8_t> cells((size_t)n * n);
+        for (int y = 0; y < n; ++y)
+            for (int x = 0; x < n; ++x)
+                cells[(size_t)y * n + x] = map.isWall(x, y);
+        double buildMs = benchMs([&]
+                                 { full.build(cells.data(), n, n); });
+
+        // slam sized carves, each patches the field locally
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<float> coord(0.0f, (float)n * Tilemap::TILE_SIZE);
+        const int CARVES = 200;
+        std::vector<Vector2> holes(CARVES);
+        for (auto &h : holes)
+            h = {coord(rng), coord(rng)};
+        double carveMs = benchMs([&]
+                                 { for (auto &h : holes) map.carveCircle(h, 96.0f, true); });
+
+        for (int y = 0; y < n; ++y)
+            for (int x = 0; x < n; ++x)
+                cells[(size_t)y * n + x] = map.isWall(x, y);
+        double rebuildMs = benchMs([&]
+                                   { full.build(cells.data(), n, n); });
+        bool match = true;
+        for (int y = 0; y < n && match; ++y)
+            for (int x = 0; x < n; ++x)
+                if (full.at(x, y) != map.getClearance().at(x, y))
+                {
+                    match = false;
+                    break;
+                }
+
+        printf("size %d: build %.2f ms, carve + patch %.1f us, full rebuild %.2f ms, patched == rebuilt: %s\n",
+               n, buildMs, carveMs * 1000.0 / CARVES, rebuildMs, match ? "yes" : "NO");
+        if (!match)
+            return 1;
+
+        // circles flying across the cave until they touch a wall, stepped like Bullet::update
+        // (2 substeps a frame at 60fps). bullets are 4px, boulders 16px, bigger ones for reference
+        printf("  %-8s %10s %12s %12s\n", "radius", "steps", "loop ns", "lookup ns");
+        for (float radius : {4.0f, 16.0f, 48.0f, 96.0f})
+        {
+            const int SHOTS = 20000;
+            std::uniform_real_distribution<float> angle(0.0f, 6.2832f);
+            std::vector<Vector2> from(SHOTS), step(SHOTS);
+            for (int i = 0; i < SHOTS; ++i)
+            {
+                float a = angle(rng);
+                from[i] = map.randomFloorPosition(rng);
+                step[i] = {cosf(a) * 900.0f / 120.0f, sinf(a) * 900.0f / 120.0f};
+            }
+            auto fly = [&](auto hitTest)
+            {
+                long steps = 0;
+                for (int i = 0; i < SHOTS; ++i)
+                {
+                    Vector2 p = from[i];
+                    for (int k = 0; k < 4000 && !hitTest(p); ++k, ++steps)
+                        p = {p.x + step[i].x, p.y + step[i].y};
+                }
+                return steps;
+            };
+            long stepsLoop = 0, stepsLookup = 0;
+            double loopMs = benchMs([&]
+                                    { stepsLoop = fly([&](Vector2 p)
+                                                      { return circleHitsWallLoop(map, p, radius); }); });
+            double lookupMs = benchMs([&]
+                                      { stepsLookup = fly([&](Vector2 p)
+                                                          { return map.circleHitsWall(p, radius); }); });
+            double queries = (double)stepsLoop + SHOTS;
+            printf("  %-8.0f %10ld %12.1f %12.1f %s\n", radius, stepsLoop, loopMs * 1e6 / queries, lookupMs * 1e6 / queries,
+                   stepsLoop == stepsLookup ? "" : "MISMATCH");
+            if (stepsLoop != stepsLookup)
+                return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,175 @@
+// Cluster graph (HPA*) benchmark.
+//  - full build time and size per map
+//  - long queries (over ClusterGraph::LONG_QUERY_TILES) flat JPS against the graph: time,
+//    nodes, and how much longer the graph's paths are than the shortest
+//  - local rebuild time after slam sized (96px) and boulder sized (50px) carves, and a check
+//    that a patched graph finds paths of the same cost as one built from scratch
+// usage: ClusterGraphBench [size ...]
+#include "BenchCommon.hpp"
+#include "ClusterGraph.hpp"
+#include "Pathfinder.hpp"
+#include "Tilemap.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// cost of a path in 10/14 units
+static long pathCost(const Tilemap &map, Vector2 start, const std::vector<Vector2> &path)
+{
+    int x, y;
+    map.worldToTile(start, x, y);
+    long cost = 0;
+    for (const Vector2 &p : path)
+    {
+        int nx, ny;
+        map.worldToTile(p, nx, ny);
+        cost += (nx != x && ny != y) ? 14 : 10;
+        x = nx;
+        y = ny;
+    }
+    return cost;
+}
+
+// random pairs at least LONG_QUERY_TILES apart
+static void longPairs(const Tilemap &map, std::mt19937 &rng, int count, std::vector<Vector2> &from, std::vector<Vector2> &to)
+{
+    const float minPx = ClusterGraph::LONG_QUERY_TILES * (float)Tilemap::TILE_SIZE;
+    from.clear();
+    to.clear();
+    while ((int)from.size() < count)
+    {
+        Vector2 a = map.randomFloorPosition(rng), b = map.randomFloorPosition(rng);
+        if (std::max(fabsf(a.x - b.x), fabsf(a.y - b.y)) < minPx)
+            continue;
+        from.push_back(a);
+        to.push_back(b);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<int> sizes = {256, 512, 1024};
+    if (argc > 1)
+    {
+        sizes.clear();
+        for (int i = 1; i < argc; ++i)
+            sizes.push_back(atoi(argv[i]));
+    }
+    const int QUERIES = 200;
+    const int CARVES = 300;
+
+    printf("== build ==\n%-6s %10s %10s %10s\n", "size", "build ms", "nodes", "KiB");
+    for (int n : sizes)
+    {
+        Tilemap map(n, n);
+        map.generateCave(17, 45, 5);
+        ClusterGraph graph;
+        double ms = benchMs([&]
+                            { graph.build(map.data(), n, n); });
+        printf("%-6d %10.2f %10d %10.1f\n", n, ms, graph.nodeCount(), graph.memoryBytes() / 1024.0);
+    }
+
+    printf("\n== long queries ==\n%-6s %-9s %12s %12s %12s %12s\n", "size", "mode", "avg us", "worst us", "avg nodes", "cost vs best");
+    for (int n : sizes)
+    {
+        Tilemap map(n, n);
+        map.generateCave(17, 45, 5);
+        std::mt19937 rng(n);
+        std::vector<Vector2> from, to, path;
+        longPairs(map, rng, QUERIES, from, to);
+
+        Pathfinder pf;
+        std::vector<long> best(QUERIES, -1);
+        for (int useClusters = 0; useClusters < 2; ++useClusters)
+        {
+            pf.setUseClusters(useClusters != 0);
+            double total = 0.0, worst = 0.0, ratio = 0.0;
+            long nodes = 0;
+            int found = 0;
+            for (int i = 0; i < QUERIES; ++i)
+            {
+                bool ok = false;
+                double ms = benchMs([&]
+                                    { ok = pf.findPath(map, from[i], to[i], path); });
+                total += ms;
+                worst = std::max(worst, ms);
+                nodes += pf.lastExpanded();
+                if (!ok)
+                    continue;
+                long cost = pathCost(map, from[i], path);
+                if (!useClusters)
+                    best[i] = cost;
+                else if (best[i] > 0)
+                {
+                    ratio += (double)cost / best[i];
+                    found++;
+                }
+            }
+            char ratioText[32] = "1.000";
+            if (useClusters)
+                snprintf(ratioText, sizeof(ratioText), "%.3f", found ? ratio / found : 0.0);
+            printf("%-6d %-9s %12.1f %12.1f %12ld %12s\n", n, useClusters ? "clusters" : "flat JPS", total * 1000.0 / QUERIES,
+                   worst * 1000.0, nodes / QUERIES, ratioText);
+        }
+    }
+
+    printf("\n== rebuild after a carve ==\n%-6s %8s %12s %12s %14s %12s\n", "size", "radius", "avg us", "worst us", "full build ms", "bad cost");
+    for (int n : sizes)
+    {
+        for (float radius : {96.0f, 50.0f})
+        {
+            Tilemap map(n, n);
+            map.generateCave(17, 45, 5);
+            ClusterGraph graph;
+            double fullMs = benchMs([&]
+                                    { graph.build(map.data(), n, n); });
+
+            std::mt19937 rng(n + (int)radius);
+            std::vector<int> changed;
+            double total = 0.0, worst = 0.0;
+            int carves = 0;
+            for (int i = 0; i < CARVES; ++i)
+            {
+                CarveStamp st{map.randomFloorPosition(rng), radius, true};
+                changed.clear();
+                map.carveCircles(&st, 1, &changed);
+                if (changed.empty())
+                    continue;
+                int minX = n, minY = n, maxX = -1, maxY = -1;
+                for (int t : changed)
+                {
+                    minX = std::min(minX, t % n);
+                    maxX = std::max(maxX, t % n);
+                    minY = std::min(minY, t / n);
+                    maxY = std::max(maxY, t / n);
+                }
+                double ms = benchMs([&]
+                                    { graph.update(map.data(), minX, minY, maxX, maxY); });
+                total += ms;
+                worst = std::max(worst, ms);
+                carves++;
+            }
+
+            // the patched graph against a fresh one, the costs have to match
+            ClusterGraph fresh;
+            fresh.build(map.data(), n, n);
+            std::vector<Vector2> from, to, path;
+            longPairs(map, rng, QUERIES, from, to);
+            ClusterGraph::Search search;
+            int bad = 0;
+            for (int i = 0; i < QUERIES; ++i)
+            {
+                int sx, sy, gx, gy, e;
+                map.worldToTile(from[i], sx, sy);
+                map.worldToTile(to[i], gx, gy);
+                long a = graph.findPath(map, sx, sy, gx, gy, path, search, e) ? pathCost(map, from[i], path) : -1;
+                long b = fresh.findPath(map, sx, sy, gx, gy, path, search, e) ? pathCost(map, from[i], path) : -1;
+                bad += (a != b);
+            }
+            printf("%-6d %8.0f %12.1f %12.1f %14.2f %12d\n", n, radius, carves ? total * 1000.0 / carves : 0.0,
+                   worst * 1000.0, fullMs, bad);
+        }
+    }
+    return 0;
+}
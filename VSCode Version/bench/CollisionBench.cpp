@@ -0,0 +1,166 @@
+// Collision benchmark: circles pushed around the cave at walking, dash and silly speeds
+// (up to 40 tiles a frame), through the old centre point test and the swept resolveCollision,
+// one call each and through resolveCollisions. Checks the swept version never leaves a circle
+// in a wall, lands where a 0.02px march along each axis would, and counts how often the old
+// test left bodies overlapping walls or stuck (didn't move at all). At silly speeds nearly
+// every move ends on a wall and the next heading often points back into it, so swept bodies
+// are stuck a lot too: 'free' counts stuck moves where the march could have gone somewhere.
+// usage: CollisionBench [movers] [size]
+#include "BenchCommon.hpp"
+#include "Tilemap.hpp"
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// the old resolveCollision
+static bool oldResolve(const Tilemap &map, Vector2 &pos, Vector2 delta)
+{
+    Vector2 next = {pos.x + delta.x, pos.y + delta.y};
+    int tx = (int)(next.x / Tilemap::TILE_SIZE), ty = (int)(next.y / Tilemap::TILE_SIZE);
+    if (map.isWall(tx, ty))
+        return true;
+    pos = next;
+    return false;
+}
+
+// tiny steps along x then y until the next would touch a wall. offsets are kept in double
+// from the start point, adding 0.02 to a float at x = 10000 drifts by tenths of a px
+// circle overlaps a wall tile. just touching doesn't count, same as the sweep (circleHitsWall
+// counts it, and a body resting exactly on a face would stop a march sliding along it)
+static bool overlapsWall(const Tilemap &map, Vector2 p, float r)
+{
+    const float T = (float)Tilemap::TILE_SIZE;
+    for (int ty = (int)floorf((p.y - r) / T); ty <= (int)floorf((p.y + r) / T); ++ty)
+        for (int tx = (int)floorf((p.x - r) / T); tx <= (int)floorf((p.x + r) / T); ++tx)
+        {
+            if (!map.isWall(tx, ty))
+                continue;
+            float cx = fminf(fmaxf(p.x, tx * T), (tx + 1) * T), cy = fminf(fmaxf(p.y, ty * T), (ty + 1) * T);
+            if ((p.x - cx) * (p.x - cx) + (p.y - cy) * (p.y - cy) < r * r)
+                return true;
+        }
+    return false;
+}
+
+static Vector2 marched(const Tilemap &map, Vector2 p, float r, Vector2 delta)
+{
+    const double STEP = 0.02;
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        const double d = axis == 0 ? delta.x : delta.y, s = d > 0 ? STEP : -STEP;
+        const double base = axis == 0 ? p.x : p.y;
+        double done = 0.0;
+        while (fabs(done) < fabs(d))
+        {
+            double next = fabs(d - done) < STEP ? d : done + s;
+            Vector2 n = axis == 0 ? Vector2{(float)(base + next), p.y} : Vector2{p.x, (float)(base + next)};
+            if (overlapsWall(map, n, r))
+                break;
+            done = next;
+        }
+        (axis == 0 ? p.x : p.y) = (float)(base + done);
+    }
+    return p;
+}
+
+int main(int argc, char **argv)
+{
+    const int movers = (argc > 1) ? atoi(argv[1]) : 4000;
+    const int size = (argc > 2) ? atoi(argv[2]) : 512;
+    const int FRAMES = 300;
+
+    Tilemap map(size, size);
+    map.generateCave(47, 45, 5);
+    std::mt19937 rng(21);
+    std::uniform_real_distribution<float> ang(-PI, PI);
+    struct Speed
+    {
+        const char *name;
+        float px; // per frame
+    };
+    const Speed speeds[] = {{"walk 120px/s", 2.0f}, {"dash 700px/s", 11.7f}, {"40 tiles/frame", 1280.0f}};
+    const float radii[] = {10.0f, 12.0f, 14.0f, 18.0f, 26.0f}; // animal, hunter, player stages 1, 2 and 4
+
+    printf("%d movers on %d, %d frames\n", movers, size, FRAMES);
+    printf("%-16s %-8s %10s %10s %12s %10s %8s %10s\n", "speed", "method", "ns/move", "blocked%", "in wall", "stuck%", "free",
+           "off march");
+    for (const Speed &sp : speeds)
+    {
+        // same start points and headings for every method, a new heading when blocked
+        std::vector<Mover> start(movers);
+        for (Mover &m : start)
+        {
+            // bodies never start in rock, the big ones need a roomier spot
+            m = {map.randomFloorPosition(rng), radii[rng() % 5], {}};
+            while (map.circleHitsWall(m.pos, m.radius))
+                m.pos = map.randomFloorPosition(rng);
+        }
+        std::vector<float> heading(movers);
+        for (float &h : heading)
+            h = ang(rng);
+
+        for (int method = 0; method < 3; ++method)
+        {
+            std::vector<Mover> ms = start;
+            std::vector<float> hd = heading;
+            std::mt19937 turn(99);
+            long moves = 0, blocked = 0, inWall = 0, stuck = 0, freeStuck = 0, offMarch = 0;
+            double ms_ = 0.0;
+            const bool checkMarch = sp.px < 100.0f && method == 1;
+            for (int f = 0; f < FRAMES; ++f)
+            {
+                for (int i = 0; i < movers; ++i)
+                    ms[i].delta = {cosf(hd[i]) * sp.px, sinf(hd[i]) * sp.px};
+                std::vector<Mover> before = ms;
+                if (method == 0)
+                    ms_ += benchMs([&]
+                                   {
+                        for (Mover &m : ms)
+                            m.blocked = oldResolve(map, m.pos, m.delta); });
+                else if (method == 1)
+                    ms_ += benchMs([&]
+                                   {
+                        for (Mover &m : ms)
+                            m.blocked = map.resolveCollision(m.pos, m.radius, m.delta); });
+                else
+                    ms_ += benchMs([&]
+                                   { map.resolveCollisions(ms.data(), movers); });
+                for (int i = 0; i < movers; ++i)
+                {
+                    const Mover &m = ms[i];
+                    moves++;
+                    blocked += m.blocked;
+                    inWall += map.circleHitsWall(m.pos, m.radius - 0.005f);
+                    bool still = m.pos.x == before[i].pos.x && m.pos.y == before[i].pos.y;
+                    stuck += still;
+                    if (still && method == 1)
+                    {
+                        // pinned against the wall it's heading into, or should it have moved
+                        Vector2 ref = marched(map, before[i].pos, m.radius, m.delta);
+                        freeStuck += fabsf(ref.x - m.pos.x) > 0.05f || fabsf(ref.y - m.pos.y) > 0.05f;
+                    }
+                    if (checkMarch && f % 10 == 0 && i % 8 == 0)
+                    {
+                        // y marched from the swept x, the march stopping up to 0.02px short on x
+                        // can change a lot how far y gets past a corner with the bigger bodies
+                        Vector2 p = before[i].pos;
+                        float refX = marched(map, p, m.radius, {m.delta.x, 0.0f}).x;
+                        float refY = marched(map, {m.pos.x, p.y}, m.radius, {0.0f, m.delta.y}).y;
+                        offMarch += fabsf(refX - m.pos.x) > 0.05f || fabsf(refY - m.pos.y) > 0.05f;
+                    }
+                    if (m.blocked)
+                        hd[i] = ang(turn);
+                }
+            }
+            const char *names[] = {"old", "swept", "batch"};
+            char off[32] = "-", free[32] = "-";
+            if (checkMarch)
+                snprintf(off, sizeof(off), "%ld", offMarch);
+            if (method == 1)
+                snprintf(free, sizeof(free), "%ld", freeStuck);
+            printf("%-16s %-8s %10.1f %10.2f %12ld %10.2f %8s %10s\n", sp.name, names[method], ms_ * 1e6 / moves,
+                   100.0 * blocked / moves, inWall, 100.0 * stuck / moves, free, off);
+        }
+    }
+    return 0;
+}
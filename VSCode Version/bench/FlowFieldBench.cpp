@@ -0,0 +1,122 @@
+// Flow field benchmark: a squad closing in on a moving player, every hunter running its own
+// search every 0.25s (like Hunter::requestPathTo) against all of them reading one shared
+// FlowFieldService field each tick. Reports the cost per tick and how many searches ran.
+// usage: FlowFieldBench [hunters ...]
+#include "BenchCommon.hpp"
+#include "FlowFieldService.hpp"
+#include "Pathfinder.hpp"
+#include "Tilemap.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    std::vector<int> squads = {4, 64, 512};
+    if (argc > 1)
+    {
+        squads.clear();
+        for (int i = 1; i < argc; ++i)
+            squads.push_back(atoi(argv[i]));
+    }
+
+    Tilemap map(512, 512);
+    map.generateCave(23, 45, 5);
+    const int TICKS = 600; // 10 seconds at 60fps
+    const int REPATH_TICKS = 15;
+    const int PLAYER_STEP_TICKS = 10; // about 6 tiles a second
+
+    // the player wanders tile to tile, the same walk for every run
+    std::vector<Vector2> player(TICKS);
+    {
+        std::mt19937 rng(3);
+        Vector2 p = map.pickSpawnFloorNearCenter();
+        for (int t = 0; t < TICKS; ++t)
+        {
+            if (t % PLAYER_STEP_TICKS == 0)
+            {
+                for (int tries = 0; tries < 16; ++tries)
+                {
+                    int k = std::uniform_int_distribution<int>(0, 3)(rng);
+                    const int D[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+                    Vector2 n = {p.x + D[k][0] * (float)Tilemap::TILE_SIZE, p.y + D[k][1] * (float)Tilemap::TILE_SIZE};
+                    int tx, ty;
+                    map.worldToTile(n, tx, ty);
+                    if (!map.isWall(tx, ty))
+                    {
+                        p = n;
+                        break;
+                    }
+                }
+            }
+            player[t] = p;
+        }
+    }
+
+    printf("%-8s %-10s %12s %12s %16s %10s\n", "hunters", "mode", "avg ms", "worst ms", "searches/tick", "fallbacks");
+    for (int n : squads)
+    {
+        // hunters spread around the player's start, close enough to be inside the field
+        std::mt19937 rng(n);
+        std::vector<Vector2> hunters;
+        FloorQuery q;
+        q.from = player[0];
+        q.reachable = true;
+        const float maxPx = (FlowFieldService::DEFAULT_RADIUS - 8) * (float)Tilemap::TILE_SIZE;
+        while ((int)hunters.size() < n)
+        {
+            Vector2 h;
+            if (map.randomFloorPosition(rng, q, h) && fabsf(h.x - q.from.x) < maxPx && fabsf(h.y - q.from.y) < maxPx)
+                hunters.push_back(h);
+        }
+        std::vector<int> phase(n);
+        for (auto &p : phase)
+            p = std::uniform_int_distribution<int>(0, REPATH_TICKS - 1)(rng);
+
+        // everyone searches on their own
+        {
+            Pathfinder pf;
+            std::vector<Vector2> path;
+            double total = 0.0, worst = 0.0;
+            long searches = 0;
+            for (int t = 0; t < TICKS; ++t)
+            {
+                double ms = benchMs([&]
+                                    {
+                    for (int i = 0; i < n; ++i)
+                        if ((t + phase[i]) % REPATH_TICKS == 0)
+                        {
+                            pf.findPath(map, hunters[i], player[t], path);
+                            searches++;
+                        } });
+                total += ms;
+                worst = std::max(worst, ms);
+            }
+            printf("%-8d %-10s %12.3f %12.3f %16.2f %10s\n", n, "own A*", total / TICKS, worst, (double)searches / TICKS, "-");
+        }
+
+        // one shared field, every hunter reads its step every tick
+        {
+            FlowFieldService flow;
+            Vector2 next;
+            double total = 0.0, worst = 0.0;
+            long fallbacks = 0;
+            for (int t = 0; t < TICKS; ++t)
+            {
+                double ms = benchMs([&]
+                                    {
+                    flow.beginTick();
+                    for (int i = 0; i < n; ++i)
+                        if (!flow.nextStep(map, player[t], hunters[i], next))
+                            fallbacks++; });
+                total += ms;
+                worst = std::max(worst, ms);
+            }
+            flow.beginTick();
+            printf("%-8d %-10s %12.3f %12.3f %16.2f %10ld\n", n, "flow", total / TICKS, worst,
+                   (double)flow.getStats().fieldsBuilt / TICKS, fallbacks);
+        }
+    }
+    return 0;
+}
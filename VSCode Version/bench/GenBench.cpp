@@ -0,0 +1,219 @@
+// Cave generation benchmark: speed and quality of the generators over a range of seeds and sizes.
+// Per run: time per phase, floor ratio, region count before and after cleanup and the longest
+// shortest path through the cave. Writes JSON so runs can be diffed for regressions.
+// Exits nonzero if a cave comes out in more than one region or the spawn can't reach all of it.
+// usage: GenBench [--sizes 100,512,1024] [--seeds 1-10] [--gen cellular|noise|both] [--out file.json]
+#include "BenchCommon.hpp"
+#include "Tilemap.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct GenRun
+{
+    std::string generator;
+    int size = 0;
+    unsigned seed = 0;
+    CaveGenStats stats;
+    double totalMs = 0.0;
+    double floorRatio = 0.0;
+    int spawnReach = 0;  // furthest tile from the spawn, in steps
+    int longestPath = 0; // double sweep, a tight lower bound on the cave's diameter
+    bool spawnInMain = false; // the bfs from the spawn visits every floor tile
+};
+
+// 4-connected bfs, returns the furthest tile and its distance
+static int bfsFurthest(const Tilemap &map, int sx, int sy, int &fx, int &fy, std::vector<int> &dist, std::vector<int> &queue)
+{
+    const int W = map.getWidth(), H = map.getHeight();
+    dist.assign((size_t)W * H, -1);
+    queue.clear();
+    dist[(size_t)sy * W + sx] = 0;
+    queue.push_back(sy * W + sx);
+    fx = sx;
+    fy = sy;
+    int best = 0;
+    static const int DIRS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    for (size_t head = 0; head < queue.size(); ++head)
+    {
+        int x = queue[head] % W, y = queue[head] / W;
+        int d = dist[queue[head]];
+        if (d > best)
+        {
+            best = d;
+            fx = x;
+            fy = y;
+        }
+        for (auto &dir : DIRS)
+        {
+            int nx = x + dir[0], ny = y + dir[1];
+            if (map.isWall(nx, ny) || dist[(size_t)ny * W + nx] >= 0)
+                continue;
+            dist[(size_t)ny * W + nx] = d + 1;
+            queue.push_back(ny * W + nx);
+        }
+    }
+    return best;
+}
+
+static void measureCave(const Tilemap &map, GenRun &run)
+{
+    const int W = map.getWidth(), H = map.getHeight();
+    run.floorRatio = (double)map.floorTileCount() / ((double)W * H);
+
+    int sx, sy;
+    map.worldToTile(map.pickSpawnFloorNearCenter(), sx, sy);
+    if (map.isWall(sx, sy))
+        return;
+    std::vector<int> dist, queue;
+    int ax, ay, bx, by;
+    run.spawnReach = bfsFurthest(map, sx, sy, ax, ay, dist, queue);
+    run.spawnInMain = (int)queue.size() == map.floorTileCount();
+    run.longestPath = bfsFurthest(map, ax, ay, bx, by, dist, queue);
+}
+
+static std::vector<int> parseList(const char *s)
+{
+    std::vector<int> out;
+    for (const char *p = s; *p;)
+    {
+        out.push_back(atoi(p));
+        const char *comma = strchr(p, ',');
+        if (!comma)
+            break;
+        p = comma + 1;
+    }
+    return out;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<int> sizes = {100, 512, 1024};
+    unsigned firstSeed = 1, lastSeed = 10;
+    std::string gen = "both";
+    const char *outPath = nullptr;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "--sizes"))
+            sizes = parseList(argv[i + 1]);
+        else if (!strcmp(argv[i], "--seeds"))
+        {
+            firstSeed = lastSeed = (unsigned)atoi(argv[i + 1]);
+            if (const char *dash = strchr(argv[i + 1], '-'))
+                lastSeed = (unsigned)atoi(dash + 1);
+        }
+        else if (!strcmp(argv[i], "--gen"))
+            gen = argv[i + 1];
+        else if (!strcmp(argv[i], "--out"))
+            outPath = argv[i + 1];
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<GenRun> runs;
+    for (int n : sizes)
+    {
+        Tilemap map(n, n);
+        for (unsigned seed = firstSeed; seed <= lastSeed; ++seed)
+        {
+            if (gen == "cellular" || gen == "both")
+            {
+                GenRun r;
+                r.generator = "cellular";
+                r.size = n;
+                r.seed = seed;
+                r.totalMs = benchMs([&]
+                                    { map.generateCave(seed, 45, 5, &r.stats); });
+                measureCave(map, r);
+                runs.push_back(r);
+            }
+            if (gen == "noise" || gen == "both")
+            {
+                GenRun r;
+                r.generator = "noise";
+                r.size = n;
+                r.seed = seed;
+                r.totalMs = benchMs([&]
+                                    { map.generateNoiseCave(seed, NoiseCaveParams{}, 0, &r.stats); });
+                measureCave(map, r);
+                runs.push_back(r);
+            }
+            fprintf(stderr, "size %d seed %u done\n", n, seed);
+        }
+    }
+
+    FILE *out = outPath ? fopen(outPath, "w") : stdout;
+    if (!out)
+    {
+        fprintf(stderr, "can't write %s\n", outPath);
+        return 1;
+    }
+
+    fprintf(out, "{\n  \"runs\": [\n");
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        const GenRun &r = runs[i];
+        fprintf(out,
+                "    {\"generator\": \"%s\", \"size\": %d, \"seed\": %u, \"totalMs\": %.3f, "
+                "\"fillMs\": %.3f, \"smoothMs\": %.3f, \"cleanupMs\": %.3f, \"indexMs\": %.3f, "
+                "\"floorRatio\": %.4f, \"regionsBefore\": %d, \"regionsAfter\": %d, \"spawnReach\": %d, \"longestPath\": %d, \"spawnInMain\": %s}%s\n",
+                r.generator.c_str(), r.size, r.seed, r.totalMs, r.stats.fillMs, r.stats.smoothMs, r.stats.cleanupMs,
+                r.stats.indexMs, r.floorRatio, r.stats.regionsBefore, r.stats.regionsAfter,
+                r.spawnReach, r.longestPath, r.spawnInMain ? "true" : "false", (i + 1 < runs.size()) ? "," : "");
+    }
+    fprintf(out, "  ],\n  \"summary\": [\n");
+
+    // averages per generator and size
+    std::vector<std::pair<std::string, int>> groups;
+    for (auto &r : runs)
+    {
+        auto key = std::make_pair(r.generator, r.size);
+        bool seen = false;
+        for (auto &g : groups)
+            seen = seen || g == key;
+        if (!seen)
+            groups.push_back(key);
+    }
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        int count = 0, maxRegionsAfter = 0;
+        double totalMs = 0.0, floorRatio = 0.0, regionsBefore = 0.0, longestPath = 0.0;
+        for (auto &r : runs)
+        {
+            if (r.generator != groups[g].first || r.size != groups[g].second)
+                continue;
+            count++;
+            totalMs += r.totalMs;
+            floorRatio += r.floorRatio;
+            regionsBefore += r.stats.regionsBefore;
+            longestPath += r.longestPath;
+            maxRegionsAfter = std::max(maxRegionsAfter, r.stats.regionsAfter);
+        }
+        fprintf(out,
+                "    {\"generator\": \"%s\", \"size\": %d, \"seeds\": %d, \"meanTotalMs\": %.3f, \"meanFloorRatio\": %.4f, "
+                "\"meanRegionsBefore\": %.1f, \"maxRegionsAfter\": %d, \"meanLongestPath\": %.1f}%s\n",
+                groups[g].first.c_str(), groups[g].second, count, totalMs / count, floorRatio / count,
+                regionsBefore / count, maxRegionsAfter, longestPath / count, (g + 1 < groups.size()) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+
+    if (outPath)
+        fclose(out);
+
+    // every cave should be one region with the player spawned in it
+    int bad = 0;
+    for (auto &r : runs)
+        if (r.stats.regionsAfter != 1 || !r.spawnInMain)
+        {
+            fprintf(stderr, "FAIL %s size %d seed %u: regionsAfter %d, spawn %s the main cave\n", r.generator.c_str(),
+                    r.size, r.seed, r.stats.regionsAfter, r.spawnInMain ? "in" : "not in");
+            bad++;
+        }
+    return bad ? 1 : 0;
+}
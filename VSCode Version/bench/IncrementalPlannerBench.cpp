@@ -0,0 +1,176 @@
+// Incremental planner benchmark: hunters chasing a player that runs at Player::speed, one
+// repath every 0.25s like Hunter::update. Each repath goes through a from scratch search
+// (Pathfinder, A* and JPS) and through each hunter's IncrementalPlanner, with a carve near
+// the player every two seconds. Checks the repaired paths cost the same as A*. The planner
+// gets Hunter::PLAN_BUDGET queue pops a call like in game, a search that runs out continues
+// on the next repath and the hunter walks the A* path meanwhile (the scheduler's job in game).
+// usage: IncrementalPlannerBench [hunters] [size] [budget]
+#include "BenchCommon.hpp"
+#include "Hunter.hpp"
+#include "IncrementalPlanner.hpp"
+#include "Pathfinder.hpp"
+#include "Tilemap.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+static long pathCost(const Tilemap &map, Vector2 start, const std::vector<Vector2> &path)
+{
+    int x, y;
+    map.worldToTile(start, x, y);
+    long cost = 0;
+    for (const Vector2 &p : path)
+    {
+        int nx, ny;
+        map.worldToTile(p, nx, ny);
+        cost += (nx != x && ny != y) ? 14 : 10;
+        x = nx;
+        y = ny;
+    }
+    return cost;
+}
+
+int main(int argc, char **argv)
+{
+    const int hunters = (argc > 1) ? atoi(argv[1]) : 16;
+    const int size = (argc > 2) ? atoi(argv[2]) : 512;
+    const int planBudget = (argc > 3) ? atoi(argv[3]) : Hunter::PLAN_BUDGET;
+    const int REPATHS = 240;                  // a minute of chasing
+    const float playerSpeed = 180.0f;         // Player::speed
+    const float hunterSpeed = 120.0f;         // Hunter::speed
+    const float repathSeconds = 0.25f;        // Hunter::repathInterval
+    const int CARVE_EVERY = 8;                // repaths, so every 2 seconds
+
+    Tilemap map(size, size);
+    map.generateCave(29, 45, 5);
+    std::mt19937 rng(7);
+
+    // the player heads for a far point and picks a new one on arrival, moving speed*0.25 px a repath
+    Vector2 player = map.pickSpawnFloorNearCenter();
+    std::vector<Vector2> playerPath;
+    size_t playerStep = 0;
+    Pathfinder route;
+    route.setUseClusters(false);
+
+    // hunters start 10-25 tiles away
+    std::vector<Vector2> pos;
+    FloorQuery q;
+    q.from = player;
+    q.minDistTiles = 10;
+    q.reachable = true;
+    while ((int)pos.size() < hunters)
+    {
+        Vector2 h;
+        if (map.randomFloorPosition(rng, q, h) && fabsf(h.x - player.x) + fabsf(h.y - player.y) < 25 * Tilemap::TILE_SIZE)
+            pos.push_back(h);
+    }
+    std::vector<IncrementalPlanner> planners(hunters);
+    std::vector<std::vector<Vector2>> paths(hunters);
+
+    Pathfinder astar, jps;
+    astar.setMode(Pathfinder::Mode::AStar);
+    astar.setUseClusters(false);
+    jps.setUseClusters(false);
+    std::vector<Vector2> scratch;
+    double astarMs = 0, jpsMs = 0, planMs = 0;
+    long astarNodes = 0, jpsNodes = 0, planNodes = 0, queries = 0, bad = 0, overBudget = 0;
+    double worstPlan = 0;
+    std::vector<double> planTimes; // for the 99th percentile, the worst is mostly scheduler noise
+
+    for (int r = 0; r < REPATHS; ++r)
+    {
+        // move the player
+        float budget = playerSpeed * repathSeconds;
+        while (budget > 0.0f)
+        {
+            if (playerStep >= playerPath.size())
+            {
+                playerPath.clear();
+                playerStep = 0;
+                Vector2 far = map.randomFloorPosition(rng);
+                if (!route.findPath(map, player, far, playerPath))
+                    break;
+            }
+            Vector2 t = playerPath[playerStep];
+            float d = sqrtf((t.x - player.x) * (t.x - player.x) + (t.y - player.y) * (t.y - player.y));
+            if (d <= budget)
+            {
+                player = t;
+                budget -= d;
+                playerStep++;
+            }
+            else
+            {
+                player.x += (t.x - player.x) / d * budget;
+                player.y += (t.y - player.y) / d * budget;
+                budget = 0.0f;
+            }
+        }
+
+        if (r > 0 && r % CARVE_EVERY == 0)
+        {
+            std::uniform_real_distribution<float> off(-300.0f, 300.0f);
+            map.carveCircle({player.x + off(rng), player.y + off(rng)}, 50.0f);
+        }
+
+        for (int i = 0; i < hunters; ++i)
+        {
+            // hunters walk their last path for a repath interval
+            float walk = hunterSpeed * repathSeconds;
+            std::vector<Vector2> &p = paths[i];
+            size_t k = 0;
+            while (k < p.size() && walk > 0.0f)
+            {
+                float d = sqrtf((p[k].x - pos[i].x) * (p[k].x - pos[i].x) + (p[k].y - pos[i].y) * (p[k].y - pos[i].y));
+                if (d > walk)
+                {
+                    pos[i].x += (p[k].x - pos[i].x) / d * walk;
+                    pos[i].y += (p[k].y - pos[i].y) / d * walk;
+                    break;
+                }
+                pos[i] = p[k++];
+                walk -= d;
+            }
+
+            bool okA = false, okJ = false, okP = false;
+            astarMs += benchMs([&]
+                               { okA = astar.findPath(map, pos[i], player, scratch); });
+            astarNodes += astar.lastExpanded();
+            long best = okA ? pathCost(map, pos[i], scratch) : -1;
+            jpsMs += benchMs([&]
+                             { okJ = jps.findPath(map, pos[i], player, scratch); });
+            jpsNodes += jps.lastExpanded();
+            double ms = benchMs([&]
+                                { okP = planners[i].plan(map, pos[i], player, paths[i], planBudget); });
+            planMs += ms;
+            worstPlan = std::max(worstPlan, ms);
+            planTimes.push_back(ms);
+            planNodes += planners[i].lastExpanded();
+            bool outOfBudget = planners[i].lastOutOfBudget();
+            overBudget += outOfBudget;
+            if (okJ != okA || (okP != okA && !outOfBudget) || (okP && pathCost(map, pos[i], paths[i]) != best))
+                bad++;
+            if (!okP)
+                paths[i] = scratch;
+            queries++;
+        }
+    }
+
+    long repairs = 0, restarts = 0;
+    for (auto &p : planners)
+    {
+        repairs += p.getStats().repairs;
+        restarts += p.getStats().restarts;
+    }
+    printf("%d hunters on %d, %ld repaths, %ld repaired, %ld restarted\n", hunters, size, queries, repairs, restarts);
+    printf("%-14s %12s %12s\n", "mode", "avg us", "avg nodes");
+    printf("%-14s %12.1f %12.0f\n", "A* scratch", astarMs * 1000.0 / queries, (double)astarNodes / queries);
+    printf("%-14s %12.1f %12.0f\n", "JPS scratch", jpsMs * 1000.0 / queries, (double)jpsNodes / queries);
+    std::sort(planTimes.begin(), planTimes.end());
+    double p99 = planTimes.empty() ? 0.0 : planTimes[planTimes.size() * 99 / 100];
+    printf("%-14s %12.1f %12.0f   p99 %.1f us, worst %.1f us, budget %d, ran out %ld times\n", "incremental",
+           planMs * 1000.0 / queries, (double)planNodes / queries, p99 * 1000.0, worstPlan * 1000.0, planBudget, overBudget);
+    printf("paths with a different cost from A*: %ld\n", bad);
+    return 0;
+}
@@ -0,0 +1,102 @@
+// Jump Point Search benchmark: the same random queries through Pathfinder in A* and JumpPoint
+// mode, on cellular and noise caves. Reports nodes expanded and time per query, and checks
+// every JPS path is a legal 8 way walk that costs exactly the same as the A* one.
+// usage: JumpPointBench [size ...]
+#include "BenchCommon.hpp"
+#include "Pathfinder.hpp"
+#include "Tilemap.hpp"
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+// cost of a returned path in 10/14 units, or -1 if it steps through a wall or cuts a corner
+static long pathCost(const Tilemap &map, Vector2 start, const std::vector<Vector2> &path)
+{
+    int x, y;
+    map.worldToTile(start, x, y);
+    long cost = 0;
+    for (const Vector2 &p : path)
+    {
+        int nx, ny;
+        map.worldToTile(p, nx, ny);
+        int dx = nx - x, dy = ny - y;
+        if (abs(dx) > 1 || abs(dy) > 1 || (dx == 0 && dy == 0) || map.isWall(nx, ny))
+            return -1;
+        if (dx != 0 && dy != 0)
+        {
+            if (map.isWall(x + dx, y) || map.isWall(x, y + dy))
+                return -1;
+            cost += 14;
+        }
+        else
+            cost += 10;
+        x = nx;
+        y = ny;
+    }
+    return cost;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<int> sizes = {256, 512, 1024};
+    if (argc > 1)
+    {
+        sizes.clear();
+        for (int i = 1; i < argc; ++i)
+            sizes.push_back(atoi(argv[i]));
+    }
+    const int QUERIES = 400;
+
+    printf("%-6s %-9s %-10s %12s %12s %10s %10s\n", "size", "cave", "mode", "avg nodes", "avg us", "found", "bad cost");
+    for (int n : sizes)
+    {
+        for (int gen = 0; gen < 2; ++gen)
+        {
+            Tilemap map(n, n);
+            if (gen == 0)
+                map.generateCave(13, 45, 5);
+            else
+                map.generateNoiseCave(13);
+
+            std::mt19937 rng(n + gen);
+            std::vector<Vector2> from(QUERIES), to(QUERIES);
+            for (int i = 0; i < QUERIES; ++i)
+            {
+                from[i] = map.randomFloorPosition(rng);
+                to[i] = map.randomFloorPosition(rng);
+            }
+
+            // A* first, its costs are the reference
+            Pathfinder pf;
+            pf.setUseClusters(false); // flat searches only, the cluster graph has its own bench
+            std::vector<Vector2> path;
+            std::vector<long> ref(QUERIES, -1);
+            const Pathfinder::Mode modes[2] = {Pathfinder::Mode::AStar, Pathfinder::Mode::JumpPoint};
+            for (Pathfinder::Mode mode : modes)
+            {
+                pf.setMode(mode);
+                long nodes = 0;
+                int found = 0, bad = 0;
+                double ms = 0.0;
+                for (int i = 0; i < QUERIES; ++i)
+                {
+                    bool ok = false;
+                    ms += benchMs([&]
+                                  { ok = pf.findPath(map, from[i], to[i], path); });
+                    nodes += pf.lastExpanded();
+                    long cost = ok ? pathCost(map, from[i], path) : -1;
+                    found += ok;
+                    if (mode == Pathfinder::Mode::AStar)
+                        ref[i] = cost;
+                    else if (cost != ref[i])
+                        bad++;
+                }
+                printf("%-6d %-9s %-10s %12.0f %12.1f %10d %10s\n", n, gen == 0 ? "cellular" : "noise",
+                       mode == Pathfinder::Mode::AStar ? "A*" : "JPS", (double)nodes / QUERIES, ms * 1000.0 / QUERIES,
+                       found, mode == Pathfinder::Mode::AStar ? "-" : std::to_string(bad).c_str());
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+// Line of sight benchmark: hunter style sight checks (up to Hunter::sightRange) and long
+// ones across the map, through the old byte grid Bresenham (isWall per tile), the bit grid
+// hasLineOfSight, and the batched linesOfSight. Checks all three agree, then shows how
+// many checks fit in a frame at a few tile budgets.
+// usage: LineOfSightBench [size] [checks]
+#include "BenchCommon.hpp"
+#include "Tilemap.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// the walk Tilemap::hasLineOfSight used to do
+static bool oldLineOfSight(const Tilemap &map, Vector2 a, Vector2 b)
+{
+    int x0, y0, x1, y1;
+    map.worldToTile(a, x0, y0);
+    map.worldToTile(b, x1, y1);
+    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    while (true)
+    {
+        if (map.isWall(x0, y0))
+            return false;
+        if (x0 == x1 && y0 == y1)
+            break;
+        int e2 = 2 * err;
+        if (e2 >= dy)
+        {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx)
+        {
+            err += dx;
+            y0 += sy;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const int size = (argc > 1) ? atoi(argv[1]) : 512;
+    const int CHECKS = (argc > 2) ? atoi(argv[2]) : 4096;
+    const int REPEAT = 50;
+    const float SIGHT = 520.0f; // Hunter::sightRange
+
+    Tilemap map(size, size);
+    map.generateCave(31, 45, 5);
+    std::mt19937 rng(12);
+    std::uniform_real_distribution<float> ang(0.0f, 6.28f), near(0.0f, SIGHT);
+    std::uniform_real_distribution<float> anywhere(-64.0f, size * (float)Tilemap::TILE_SIZE + 64.0f);
+
+    printf("%dx%d, %d checks a batch\n", size, size, CHECKS);
+    printf("%-8s %-16s %10s %12s %10s %10s\n", "checks", "method", "us/batch", "ns/check", "clear", "mismatch");
+    for (int kind = 0; kind < 2; ++kind)
+    {
+        std::vector<Vector2> a(CHECKS), b(CHECKS);
+        for (int i = 0; i < CHECKS; ++i)
+        {
+            a[i] = map.randomFloorPosition(rng);
+            if (kind == 0)
+            {
+                float t = ang(rng), d = near(rng);
+                b[i] = {a[i].x + cosf(t) * d, a[i].y + sinf(t) * d};
+            }
+            else
+                b[i] = {anywhere(rng), anywhere(rng)};
+        }
+        const char *name = kind == 0 ? "sight" : "long";
+
+        std::vector<uint8_t> ref(CHECKS);
+        std::vector<uint64_t> mask((CHECKS + 63) / 64);
+        long clear = 0, mismatch = 0;
+        double oldMs = benchMs([&]
+                               {
+            for (int r = 0; r < REPEAT; ++r)
+                for (int i = 0; i < CHECKS; ++i)
+                    ref[i] = oldLineOfSight(map, a[i], b[i]); });
+        for (int i = 0; i < CHECKS; ++i)
+            clear += ref[i];
+
+        volatile int sink = 0;
+        double oneMs = benchMs([&]
+                               {
+            for (int r = 0; r < REPEAT; ++r)
+                for (int i = 0; i < CHECKS; ++i)
+                    sink = sink + map.hasLineOfSight(a[i], b[i]); });
+        for (int i = 0; i < CHECKS; ++i)
+            mismatch += map.hasLineOfSight(a[i], b[i]) != (bool)ref[i];
+        long mismatchOne = mismatch;
+
+        double batchMs = benchMs([&]
+                                 {
+            for (int r = 0; r < REPEAT; ++r)
+                map.linesOfSight(a.data(), b.data(), CHECKS, mask.data()); });
+        mismatch = 0;
+        for (int i = 0; i < CHECKS; ++i)
+            mismatch += (bool)((mask[i >> 6] >> (i & 63)) & 1u) != (bool)ref[i];
+
+        auto row = [&](const char *method, double ms, long bad)
+        {
+            printf("%-8s %-16s %10.1f %12.1f %10ld %10ld\n", name, method, ms * 1000.0 / REPEAT,
+                   ms * 1e6 / REPEAT / CHECKS, clear, bad);
+        };
+        row("old bytes", oldMs, 0);
+        row("hasLineOfSight", oneMs, mismatchOne);
+        row("linesOfSight", batchMs, mismatch);
+
+        // budgets: how many checks a frame gets through, and what that frame costs
+        for (long budget : {2000L, 20000L, 200000L})
+        {
+            int frames = 0;
+            double worst = 0.0;
+            for (int done = 0; done < CHECKS; frames++)
+            {
+                double ms = benchMs([&]
+                                    { done = map.linesOfSight(a.data(), b.data(), CHECKS, mask.data(), budget, done); });
+                worst = std::max(worst, ms);
+            }
+            printf("%-8s budget %-9ld %10.1f us worst frame, %d frames for the batch (%.1f checks a frame)\n", name,
+                   budget, worst * 1000.0, frames, (double)CHECKS / frames);
+        }
+    }
+    return 0;
+}
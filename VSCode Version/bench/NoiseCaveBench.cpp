@@ -0,0 +1,68 @@
+// Cave generator benchmark: cellular (random fill + smoothing) against the noise generator,
+// single thread and all threads, in tiles per second including the region cleanup.
+// Also checks a noise block made on its own matches the same tiles of the full map.
+// usage: NoiseCaveBench [size ...]
+#include "BenchCommon.hpp"
+#include "Tilemap.hpp"
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+static double floorPercent(const Tilemap &m)
+{
+    long floor = 0;
+    for (int y = 0; y < m.getHeight(); ++y)
+        for (int x = 0; x < m.getWidth(); ++x)
+            floor += !m.isWall(x, y);
+    return 100.0 * floor / ((double)m.getWidth() * m.getHeight());
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<int> sizes = {256, 1024, 4096};
+    if (argc > 1)
+    {
+        sizes.clear();
+        for (int i = 1; i < argc; ++i)
+            sizes.push_back(atoi(argv[i]));
+    }
+    const int hw = (int)std::max(1u, std::thread::hardware_concurrency());
+
+    printf("%-6s %-16s %10s %14s %8s\n", "size", "generator", "ms", "Mtiles/s", "floor%");
+    for (int n : sizes)
+    {
+        Tilemap map(n, n);
+        double tiles = (double)n * n;
+        auto row = [&](const char *name, double ms)
+        {
+            printf("%-6d %-16s %10.2f %14.2f %8.1f\n", n, name, ms, tiles / (ms * 1000.0), floorPercent(map));
+        };
+
+        row("cellular", benchMs([&]
+                                { map.generateCave(7, 45, 5); }));
+        row("noise 1 thread", benchMs([&]
+                                      { map.generateNoiseCave(7, NoiseCaveParams{}, 1); }));
+        if (hw > 1)
+        {
+            char name[32];
+            snprintf(name, sizeof(name), "noise %d threads", hw);
+            row(name, benchMs([&]
+                              { map.generateNoiseCave(7, NoiseCaveParams{}, hw); }));
+        }
+
+        // raw noise, no cleanup, a block from the middle against the whole map
+        NoiseCaveParams p;
+        std::vector<uint8_t> whole((size_t)n * n), block((size_t)64 * 64);
+        fillNoiseCave(7, p, 0, 0, n, n, whole.data(), hw);
+        int bx = n / 2, by = n / 3;
+        fillNoiseCave(7, p, bx, by, 64, 64, block.data(), 1);
+        for (int y = 0; y < 64 && by + y < n; ++y)
+            for (int x = 0; x < 64 && bx + x < n; ++x)
+                if (block[(size_t)y * 64 + x] != whole[(size_t)(by + y) * n + bx + x])
+                {
+                    printf("block at %d,%d doesn't match the full map\n", bx, by);
+                    return 1;
+                }
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+// Open list benchmark: the same queries through Pathfinder with the old binary heap and
+// with the BucketQueue, for A* and JPS. Checks the path costs agree and counts heap
+// allocations once the scratch has warmed up (operator new is counted in this file).
+// usage: OpenListBench [size] [queries]
+#include "BenchCommon.hpp"
+#include "Pathfinder.hpp"
+#include "Tilemap.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+static std::atomic<long> allocations{0};
+
+void *operator new(size_t n)
+{
+    allocations++;
+    if (void *p = malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+static long pathCost(const Tilemap &map, Vector2 start, const std::vector<Vector2> &path)
+{
+    int x, y;
+    map.worldToTile(start, x, y);
+    long cost = 0;
+    for (const Vector2 &p : path)
+    {
+        int nx, ny;
+        map.worldToTile(p, nx, ny);
+        cost += (nx != x && ny != y) ? 14 : 10;
+        x = nx;
+        y = ny;
+    }
+    return cost;
+}
+
+int main(int argc, char **argv)
+{
+    const int size = (argc > 1) ? atoi(argv[1]) : 512;
+    const int QUERIES = (argc > 2) ? atoi(argv[2]) : 2000;
+
+    Tilemap map(size, size);
+    map.generateCave(17, 45, 5);
+
+    // reachable pairs up to 60 tiles apart, so they stay under the cluster graph's cut-off
+    std::mt19937 rng(9);
+    std::vector<Vector2> from, to;
+    FloorQuery q;
+    q.reachable = true;
+    while ((int)from.size() < QUERIES)
+    {
+        Vector2 a = map.randomFloorPosition(rng), b;
+        q.from = a;
+        if (map.randomFloorPosition(rng, q, b) && fabsf(a.x - b.x) < 60 * Tilemap::TILE_SIZE &&
+            fabsf(a.y - b.y) < 60 * Tilemap::TILE_SIZE)
+        {
+            from.push_back(a);
+            to.push_back(b);
+        }
+    }
+
+    struct Run
+    {
+        const char *name;
+        Pathfinder::Mode mode;
+        Pathfinder::OpenList list;
+    };
+    const Run runs[] = {{"A* heap", Pathfinder::Mode::AStar, Pathfinder::OpenList::BinaryHeap},
+                        {"A* buckets", Pathfinder::Mode::AStar, Pathfinder::OpenList::Buckets},
+                        {"JPS heap", Pathfinder::Mode::JumpPoint, Pathfinder::OpenList::BinaryHeap},
+                        {"JPS buckets", Pathfinder::Mode::JumpPoint, Pathfinder::OpenList::Buckets}};
+
+    std::vector<long> reference(QUERIES, -1);
+    printf("%dx%d, %d queries\n", size, size, QUERIES);
+    printf("%-12s %10s %10s %12s %10s\n", "open list", "avg us", "avg nodes", "allocations", "cost diff");
+    for (const Run &r : runs)
+    {
+        Pathfinder pf;
+        pf.setMode(r.mode);
+        pf.setOpenList(r.list);
+        pf.setUseClusters(false);
+        std::vector<Vector2> path;
+        path.reserve(4096);
+
+        // one pass to grow the scratch, then measure
+        for (int i = 0; i < QUERIES; ++i)
+            pf.findPath(map, from[i], to[i], path);
+
+        long nodes = 0, diff = 0;
+        long before = allocations;
+        double ms = benchMs([&]
+                            {
+            for (int i = 0; i < QUERIES; ++i)
+            {
+                bool ok = pf.findPath(map, from[i], to[i], path);
+                nodes += pf.lastExpanded();
+                long c = ok ? pathCost(map, from[i], path) : -1;
+                if (reference[i] < 0)
+                    reference[i] = c;
+                else if (reference[i] != c)
+                    diff++;
+            } });
+        printf("%-12s %10.2f %10.0f %12ld %10ld\n", r.name, ms * 1000.0 / QUERIES, (double)nodes / QUERIES,
+               allocations - before, diff);
+    }
+    return 0;
+}
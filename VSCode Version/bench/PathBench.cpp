@@ -0,0 +1,443 @@
+// Pathfinding benchmark and validation: caves from fixed seeds and sizes, a replayable set of
+// hunter style queries on each (patrol goals 80px to Hunter::patrolRadius from home, chase
+// goals up to Hunter::maxChaseRange), run through Tilemap::findPath and a few Pathfinder
+// setups. Reports ns per query, nodes expanded and path cost, and checks every path against
+// a plain Dijkstra to the tile it ended on (so redirected goals are checked too).
+// Queries can be saved and loaded so later engines get exactly the same ones.
+// usage: PathBench [--sizes 256,512] [--seeds 1-3] [--gen cellular|noise|both] [--queries 1000]
+//                  [--save queries.txt | --load queries.txt] [--out file.json]
+#include "BenchCommon.hpp"
+#include "Hunter.hpp"
+#include "Pathfinder.hpp"
+#include "Tilemap.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Query
+{
+    char kind; // 'p' patrol, 'c' chase
+    Vector2 start, goal;
+};
+
+// one cave and the queries recorded on it
+struct QuerySet
+{
+    std::string generator;
+    int size = 0;
+    unsigned seed = 0;
+    std::vector<Query> queries;
+};
+
+struct EngineRun
+{
+    std::string generator, engine;
+    int size = 0;
+    unsigned seed = 0;
+    char kind = 'p';
+    int queries = 0, found = 0, redirected = 0;
+    int optimal = 0, invalid = 0, missed = 0; // missed: no path but Dijkstra found one
+    double ns = 0.0, nodes = 0.0, cost = 0.0, worstRatio = 1.0;
+};
+
+static std::vector<int> parseList(const char *s)
+{
+    std::vector<int> out;
+    for (const char *p = s; *p;)
+    {
+        out.push_back(atoi(p));
+        const char *comma = strchr(p, ',');
+        if (!comma)
+            break;
+        p = comma + 1;
+    }
+    return out;
+}
+
+static void generate(Tilemap &map, const QuerySet &set)
+{
+    map.resize(set.size, set.size);
+    if (set.generator == "noise")
+        map.generateNoiseCave(set.seed);
+    else
+        map.generateCave(set.seed, 45, 5);
+}
+
+// the same goals Hunter asks for: patrol around a home tile, chase towards a player in range
+static void recordQueries(const Tilemap &map, QuerySet &set, int count)
+{
+    const Hunter ref{};
+    std::mt19937 rng(set.seed * 7919u + set.size);
+    std::uniform_real_distribution<float> ang(0.0f, 6.28f), patrol(80.0f, ref.patrolRadius);
+    FloorQuery near;
+    near.reachable = true;
+    while ((int)set.queries.size() < count)
+    {
+        Vector2 home = map.randomFloorPosition(rng);
+        float a = ang(rng), d = patrol(rng);
+        set.queries.push_back({'p', home, {home.x + cosf(a) * d, home.y + sinf(a) * d}});
+    }
+    while ((int)set.queries.size() < 2 * count)
+    {
+        Vector2 player = map.randomFloorPosition(rng), hunter;
+        near.from = player;
+        if (!map.randomFloorPosition(rng, near, hunter))
+            continue;
+        float dx = hunter.x - player.x, dy = hunter.y - player.y;
+        if (dx * dx + dy * dy <= ref.maxChaseRange * ref.maxChaseRange)
+            set.queries.push_back({'c', hunter, player});
+    }
+}
+
+static bool saveQueries(const char *path, const std::vector<QuerySet> &sets)
+{
+    FILE *f = fopen(path, "w");
+    if (!f)
+        return false;
+    for (const QuerySet &s : sets)
+    {
+        fprintf(f, "map %s %d %u %zu\n", s.generator.c_str(), s.size, s.seed, s.queries.size());
+        for (const Query &q : s.queries)
+            fprintf(f, "%c %.2f %.2f %.2f %.2f\n", q.kind, q.start.x, q.start.y, q.goal.x, q.goal.y);
+    }
+    fclose(f);
+    return true;
+}
+
+static bool loadQueries(const char *path, std::vector<QuerySet> &sets)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return false;
+    char gen[32];
+    QuerySet s;
+    size_t n;
+    while (fscanf(f, " map %31s %d %u %zu", gen, &s.size, &s.seed, &n) == 4)
+    {
+        s.generator = gen;
+        s.queries.resize(n);
+        for (Query &q : s.queries)
+            if (fscanf(f, " %c %f %f %f %f", &q.kind, &q.start.x, &q.start.y, &q.goal.x, &q.goal.y) != 5)
+            {
+                fclose(f);
+                return false;
+            }
+        sets.push_back(s);
+    }
+    fclose(f);
+    return !sets.empty();
+}
+
+// reference: plain Dijkstra, same moves as Pathfinder (8 way, 10/14, no corner cutting).
+// -1 if the goal can't be reached
+class Dijkstra
+{
+public:
+    long cost(const Tilemap &map, int sx, int sy, int gx, int gy)
+    {
+        static const int D[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1}};
+        const int W = map.getWidth();
+        if (dist.size() != (size_t)W * map.getHeight())
+            dist.assign((size_t)W * map.getHeight(), -1);
+        for (int i : touched)
+            dist[i] = -1;
+        touched.clear();
+        if (map.isWall(gx, gy))
+            return -1;
+
+        std::priority_queue<std::pair<long, int>, std::vector<std::pair<long, int>>, std::greater<>> open;
+        dist[sy * W + sx] = 0;
+        touched.push_back(sy * W + sx);
+        open.push({0, sy * W + sx});
+        while (!open.empty())
+        {
+            auto [d, i] = open.top();
+            open.pop();
+            if (d > dist[i])
+                continue;
+            int x = i % W, y = i / W;
+            if (x == gx && y == gy)
+                return d;
+            for (int k = 0; k < 8; ++k)
+            {
+                int nx = x + D[k][0], ny = y + D[k][1];
+                if (map.isWall(nx, ny))
+                    continue;
+                if (k >= 4 && (map.isWall(nx, y) || map.isWall(x, ny)))
+                    continue;
+                int n = ny * W + nx;
+                long nd = d + (k >= 4 ? 14 : 10);
+                if (dist[n] < 0 || nd < dist[n])
+                {
+                    if (dist[n] < 0)
+                        touched.push_back(n);
+                    dist[n] = nd;
+                    open.push({nd, n});
+                }
+            }
+        }
+        return -1;
+    }
+
+private:
+    std::vector<long> dist;
+    std::vector<int> touched;
+};
+
+// cost in 10/14 units, -1 if a step isn't a legal move
+static long pathCost(const Tilemap &map, int x, int y, const std::vector<Vector2> &path)
+{
+    long cost = 0;
+    for (const Vector2 &p : path)
+    {
+        int nx, ny;
+        map.worldToTile(p, nx, ny);
+        int dx = nx - x, dy = ny - y;
+        if (abs(dx) > 1 || abs(dy) > 1 || (dx == 0 && dy == 0) || map.isWall(nx, ny))
+            return -1;
+        if (dx != 0 && dy != 0 && (map.isWall(x + dx, y) || map.isWall(x, y + dy)))
+            return -1;
+        cost += (dx != 0 && dy != 0) ? 14 : 10;
+        x = nx;
+        y = ny;
+    }
+    return cost;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<int> sizes = {256, 512};
+    unsigned firstSeed = 1, lastSeed = 3;
+    std::string gen = "both";
+    int perKind = 1000;
+    const char *savePath = nullptr, *loadPath = nullptr, *outPath = nullptr;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "--sizes"))
+            sizes = parseList(argv[i + 1]);
+        else if (!strcmp(argv[i], "--seeds"))
+        {
+            firstSeed = lastSeed = (unsigned)atoi(argv[i + 1]);
+            if (const char *dash = strchr(argv[i + 1], '-'))
+                lastSeed = (unsigned)atoi(dash + 1);
+        }
+        else if (!strcmp(argv[i], "--gen"))
+            gen = argv[i + 1];
+        else if (!strcmp(argv[i], "--queries"))
+            perKind = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--save"))
+            savePath = argv[i + 1];
+        else if (!strcmp(argv[i], "--load"))
+            loadPath = argv[i + 1];
+        else if (!strcmp(argv[i], "--out"))
+            outPath = argv[i + 1];
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // part 1: caves and their queries, recorded now or loaded from an earlier run
+    std::vector<QuerySet> sets;
+    Tilemap map;
+    if (loadPath)
+    {
+        if (!loadQueries(loadPath, sets))
+        {
+            fprintf(stderr, "can't read %s\n", loadPath);
+            return 1;
+        }
+    }
+    else
+    {
+        for (int n : sizes)
+            for (unsigned seed = firstSeed; seed <= lastSeed; ++seed)
+                for (const char *g : {"cellular", "noise"})
+                {
+                    if (gen != "both" && gen != g)
+                        continue;
+                    QuerySet s;
+                    s.generator = g;
+                    s.size = n;
+                    s.seed = seed;
+                    generate(map, s);
+                    recordQueries(map, s, perKind);
+                    sets.push_back(s);
+                }
+    }
+    if (savePath && !saveQueries(savePath, sets))
+    {
+        fprintf(stderr, "can't write %s\n", savePath);
+        return 1;
+    }
+
+    // the engines. findPath is whatever the game uses today, the rest pin one setup each
+    Pathfinder heapAStar, aStar, jps;
+    heapAStar.setMode(Pathfinder::Mode::AStar);
+    heapAStar.setOpenList(Pathfinder::OpenList::BinaryHeap);
+    heapAStar.setRedirectTiles(0);
+    heapAStar.setUseClusters(false);
+    aStar.setMode(Pathfinder::Mode::AStar);
+    aStar.setUseClusters(false);
+    jps.setUseClusters(false);
+    struct Engine
+    {
+        const char *name;
+        std::function<bool(Vector2, Vector2, std::vector<Vector2> &, int &)> run;
+    };
+    auto pathfinder = [&](Pathfinder &pf)
+    {
+        return [&map, &pf](Vector2 a, Vector2 b, std::vector<Vector2> &out, int &nodes)
+        {
+            bool ok = pf.findPath(map, a, b, out);
+            nodes = pf.lastExpanded();
+            return ok;
+        };
+    };
+    const Engine engines[] = {
+        {"findPath", [&](Vector2 a, Vector2 b, std::vector<Vector2> &out, int &nodes)
+         {
+             bool ok = map.findPath(a, b, out);
+             nodes = Pathfinder::forThread().lastExpanded();
+             return ok;
+         }},
+        {"astar-heap", pathfinder(heapAStar)},
+        {"astar", pathfinder(aStar)},
+        {"jps", pathfinder(jps)}};
+
+    // parts 2 and 3: replay and check
+    std::vector<EngineRun> runs;
+    Dijkstra reference;
+    std::vector<Vector2> path;
+    for (const QuerySet &s : sets)
+    {
+        generate(map, s);
+        for (char kind : {'p', 'c'})
+        {
+            std::vector<const Query *> qs;
+            for (const Query &q : s.queries)
+                if (q.kind == kind)
+                    qs.push_back(&q);
+            if (qs.empty())
+                continue;
+
+            // whether each goal can be reached at all, for the missed count
+            std::vector<long> direct(qs.size());
+            for (size_t i = 0; i < qs.size(); ++i)
+            {
+                int sx, sy, gx, gy;
+                map.worldToTile(qs[i]->start, sx, sy);
+                map.worldToTile(qs[i]->goal, gx, gy);
+                direct[i] = reference.cost(map, sx, sy, gx, gy);
+            }
+
+            for (const Engine &e : engines)
+            {
+                EngineRun r;
+                r.generator = s.generator;
+                r.engine = e.name;
+                r.size = s.size;
+                r.seed = s.seed;
+                r.kind = kind;
+                r.queries = (int)qs.size();
+
+                // timing pass on its own so the checks don't get in the way
+                for (const Query *q : qs)
+                {
+                    int nodes = 0;
+                    e.run(q->start, q->goal, path, nodes); // warm up
+                }
+                double ms = benchMs([&]
+                                    {
+                    for (const Query *q : qs)
+                    {
+                        int nodes = 0;
+                        e.run(q->start, q->goal, path, nodes);
+                    } });
+                r.ns = ms * 1e6 / qs.size();
+
+                long nodeSum = 0;
+                double costSum = 0.0;
+                for (size_t i = 0; i < qs.size(); ++i)
+                {
+                    int nodes = 0;
+                    bool ok = e.run(qs[i]->start, qs[i]->goal, path, nodes);
+                    nodeSum += nodes;
+                    if (!ok)
+                    {
+                        r.missed += direct[i] >= 0;
+                        continue;
+                    }
+                    r.found++;
+                    int sx, sy, gx, gy, ex = 0, ey = 0;
+                    map.worldToTile(qs[i]->start, sx, sy);
+                    map.worldToTile(qs[i]->goal, gx, gy);
+                    if (path.empty())
+                    {
+                        ex = sx;
+                        ey = sy;
+                    }
+                    else
+                        map.worldToTile(path.back(), ex, ey);
+                    bool moved = (ex != gx || ey != gy);
+                    r.redirected += moved;
+                    long c = pathCost(map, sx, sy, path);
+                    long best = moved ? reference.cost(map, sx, sy, ex, ey) : direct[i];
+                    if (c < 0 || best < 0)
+                    {
+                        r.invalid++;
+                        continue;
+                    }
+                    costSum += c;
+                    if (c == best)
+                        r.optimal++;
+                    else if (best > 0)
+                        r.worstRatio = std::max(r.worstRatio, (double)c / best);
+                }
+                r.nodes = (double)nodeSum / qs.size();
+                r.cost = r.found ? costSum / r.found : 0.0;
+                runs.push_back(r);
+            }
+        }
+        fprintf(stderr, "%s %d seed %u done\n", s.generator.c_str(), s.size, s.seed);
+    }
+
+    printf("%-9s %5s %4s %-7s %-11s %8s %10s %9s %9s %9s %9s %7s %7s\n", "gen", "size", "seed", "kind", "engine", "found",
+           "ns/query", "nodes", "cost", "optimal", "worst", "redir", "bad");
+    for (const EngineRun &r : runs)
+        printf("%-9s %5d %4u %-7s %-11s %8d %10.0f %9.1f %9.1f %8.1f%% %9.3f %7d %7d\n", r.generator.c_str(), r.size,
+               r.seed, r.kind == 'p' ? "patrol" : "chase", r.engine.c_str(), r.found, r.ns, r.nodes, r.cost,
+               r.found ? 100.0 * r.optimal / r.found : 100.0, r.worstRatio, r.redirected, r.invalid + r.missed);
+
+    if (outPath)
+    {
+        FILE *out = fopen(outPath, "w");
+        if (!out)
+        {
+            fprintf(stderr, "can't write %s\n", outPath);
+            return 1;
+        }
+        fprintf(out, "{\n  \"runs\": [\n");
+        for (size_t i = 0; i < runs.size(); ++i)
+        {
+            const EngineRun &r = runs[i];
+            fprintf(out,
+                    "    {\"generator\": \"%s\", \"size\": %d, \"seed\": %u, \"kind\": \"%s\", \"engine\": \"%s\", "
+                    "\"queries\": %d, \"found\": %d, \"nsPerQuery\": %.1f, \"meanNodes\": %.2f, \"meanCost\": %.2f, "
+                    "\"optimal\": %d, \"worstRatio\": %.4f, \"redirected\": %d, \"invalid\": %d, \"missed\": %d}%s\n",
+                    r.generator.c_str(), r.size, r.seed, r.kind == 'p' ? "patrol" : "chase", r.engine.c_str(), r.queries,
+                    r.found, r.ns, r.nodes, r.cost, r.optimal, r.worstRatio, r.redirected, r.invalid, r.missed,
+                    (i + 1 < runs.size()) ? "," : "");
+        }
+        fprintf(out, "  ]\n}\n");
+        fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+// Path scheduler benchmark: a squad repathing every 0.25s like Hunter::update, searched on the
+// spot against queued through PathScheduler with a 1ms budget. Reports the worst frame, the
+// average frame and how long requests waited.
+// usage: PathSchedulerBench [hunters ...]
+#include "BenchCommon.hpp"
+#include "PathScheduler.hpp"
+#include "Pathfinder.hpp"
+#include "Tilemap.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    std::vector<int> squads = {16, 64, 256};
+    if (argc > 1)
+    {
+        squads.clear();
+        for (int i = 1; i < argc; ++i)
+            squads.push_back(atoi(argv[i]));
+    }
+
+    Tilemap map(512, 512);
+    map.generateCave(21, 45, 5);
+    const int TICKS = 600; // 10 seconds at 60fps
+    const int REPATH_TICKS = 15;
+
+    printf("%-8s %-10s %12s %12s %12s %14s %14s\n", "hunters", "mode", "worst ms", "avg ms", "searches", "avg wait ms", "max wait ticks");
+    for (int n : squads)
+    {
+        // each hunter walks between random spots, goals up to ~700px away like a chase
+        std::mt19937 rng(n);
+        std::vector<Vector2> pos(n), goal(n);
+        for (int i = 0; i < n; ++i)
+        {
+            pos[i] = map.randomFloorPosition(rng);
+            goal[i] = pos[i];
+            std::uniform_real_distribution<float> ang(0.0f, 6.2832f), dist(80.0f, 700.0f);
+            for (int tries = 0; tries < 200; ++tries)
+            {
+                float a = ang(rng), d = dist(rng);
+                Vector2 g = {pos[i].x + cosf(a) * d, pos[i].y + sinf(a) * d};
+                int tx, ty;
+                map.worldToTile(g, tx, ty);
+                if (!map.isWall(tx, ty))
+                {
+                    goal[i] = g;
+                    break;
+                }
+            }
+        }
+        std::uniform_int_distribution<int> prio(0, 2);
+        std::uniform_int_distribution<int> phase(0, REPATH_TICKS - 1);
+        std::vector<int> offset(n);
+        for (auto &o : offset)
+            o = phase(rng);
+
+        // on the spot, state changes line up so a third of the squad asks on the same frame
+        {
+            std::vector<Vector2> path;
+            double worst = 0.0, total = 0.0;
+            long searches = 0;
+            for (int t = 0; t < TICKS; ++t)
+            {
+                double ms = benchMs([&]
+                                    {
+                    for (int i = 0; i < n; ++i)
+                        if ((t + offset[i] * (i % 3 == 0 ? 0 : 1)) % REPATH_TICKS == 0)
+                        {
+                            map.findPath(pos[i], goal[i], path);
+                            searches++;
+                        } });
+                worst = std::max(worst, ms);
+                total += ms;
+            }
+            printf("%-8d %-10s %12.3f %12.3f %12ld %14s %14s\n", n, "sync", worst, total / TICKS, searches, "-", "-");
+        }
+
+        // same requests through the scheduler
+        {
+            PathScheduler sched;
+            sched.setBudget(1.0f, 20000);
+            std::vector<Vector2> path;
+            double worst = 0.0, total = 0.0;
+            for (int t = 0; t < TICKS; ++t)
+            {
+                double ms = benchMs([&]
+                                    {
+                    for (int i = 0; i < n; ++i)
+                    {
+                        sched.takeResult(i, path);
+                        if ((t + offset[i] * (i % 3 == 0 ? 0 : 1)) % REPATH_TICKS == 0)
+                            sched.request(i, pos[i], goal[i], (PathScheduler::Priority)prio(rng));
+                    }
+                    sched.update(map); });
+                worst = std::max(worst, ms);
+                total += ms;
+            }
+            const PathScheduler::Stats &st = sched.getStats();
+            printf("%-8d %-10s %12.3f %12.3f %12ld %14.2f %14d\n", n, "scheduled", worst, total / TICKS, st.completed,
+                   st.avgLatencyMs, st.maxLatencyTicks);
+        }
+    }
+    return 0;
+}
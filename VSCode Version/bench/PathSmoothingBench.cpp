@@ -0,0 +1,141 @@
+// Path smoothing benchmark: hunter style repaths (patrol goals 80-220px away, chase goals
+// up to Hunter::maxChaseRange) through Pathfinder, then WaypointBuffer::pull. Reports
+// waypoints per path before and after, how much shorter the walk gets, what pulling costs,
+// heap allocations per repath once warmed up (operator new is counted in this file), and
+// how many pulled paths would have the hunter's body clip a wall.
+// usage: PathSmoothingBench [size] [queries]
+#include "BenchCommon.hpp"
+#include "Pathfinder.hpp"
+#include "Tilemap.hpp"
+#include "WaypointBuffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+static std::atomic<long> allocations{0};
+
+void *operator new(size_t n)
+{
+    allocations++;
+    if (void *p = malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+static float walkLength(Vector2 from, const Vector2 *pts, int n)
+{
+    float L = 0.0f;
+    for (int i = 0; i < n; ++i)
+    {
+        L += sqrtf((pts[i].x - from.x) * (pts[i].x - from.x) + (pts[i].y - from.y) * (pts[i].y - from.y));
+        from = pts[i];
+    }
+    return L;
+}
+
+// does the hunter's circle touch a wall anywhere along the corners, sampled every 2px
+static bool bodyHitsWall(const Tilemap &map, Vector2 from, const WaypointBuffer &w, float radius)
+{
+    for (int i = 0; i < w.size(); ++i)
+    {
+        float dx = w[i].x - from.x, dy = w[i].y - from.y;
+        int steps = (int)(sqrtf(dx * dx + dy * dy) / 2.0f) + 1;
+        for (int k = 0; k <= steps; ++k)
+            if (map.circleHitsWall({from.x + dx * k / steps, from.y + dy * k / steps}, radius - 0.5f))
+                return true;
+        from = w[i];
+    }
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    const int size = (argc > 1) ? atoi(argv[1]) : 512;
+    const int QUERIES = (argc > 2) ? atoi(argv[2]) : 4000;
+    const float HUNTER_RADIUS = 12.0f; // Hunter::radius
+
+    Tilemap map(size, size);
+    map.generateCave(21, 45, 5);
+    std::mt19937 rng(4);
+
+    struct Kind
+    {
+        const char *name;
+        float minPx, maxPx;
+    };
+    const Kind kinds[] = {{"patrol", 80.0f, 220.0f}, {"chase", 220.0f, 700.0f}};
+
+    printf("%dx%d, %d repaths each\n", size, size, QUERIES);
+    printf("%-8s %10s %10s %10s %10s %12s %10s %10s %10s\n", "goals", "tiles", "corners", "max", "cut", "walk saved",
+           "pull us", "allocs", "clipped");
+    for (const Kind &k : kinds)
+    {
+        std::vector<Vector2> from, to;
+        std::uniform_real_distribution<float> ang(0.0f, 6.28f), dist(k.minPx, k.maxPx);
+        while ((int)from.size() < QUERIES)
+        {
+            // hunters repath from wherever they stand, not from tile centres
+            std::uniform_real_distribution<float> jitter(-10.0f, 10.0f);
+            Vector2 a = map.randomFloorPosition(rng);
+            a = {a.x + jitter(rng), a.y + jitter(rng)};
+            if (map.circleHitsWall(a, HUNTER_RADIUS))
+                continue;
+            float t = ang(rng), d = dist(rng);
+            Vector2 b = {a.x + cosf(t) * d, a.y + sinf(t) * d};
+            int bx, by;
+            map.worldToTile(b, bx, by);
+            if (map.isWall(bx, by))
+                continue;
+            from.push_back(a);
+            to.push_back(b);
+        }
+
+        Pathfinder pf;
+        std::vector<Vector2> tiles;
+        WaypointBuffer corners;
+        auto repath = [&](int i)
+        {
+            if (!pf.findPath(map, from[i], to[i], tiles))
+                return false;
+            corners.pull(map, from[i], tiles, HUNTER_RADIUS);
+            return true;
+        };
+        for (int i = 0; i < QUERIES; ++i)
+            repath(i); // grow the scratch
+
+        long tileCount = 0, cornerCount = 0, cuts = 0, found = 0, clipped = 0;
+        int most = 0;
+        double tileLen = 0.0, cornerLen = 0.0, pullMs = 0.0;
+        long before = allocations;
+        for (int i = 0; i < QUERIES; ++i)
+        {
+            if (!repath(i))
+                continue;
+            found++;
+            pullMs += benchMs([&]
+                              { corners.pull(map, from[i], tiles, HUNTER_RADIUS); });
+            tileCount += (long)tiles.size();
+            cornerCount += corners.size();
+            most = std::max(most, corners.size());
+            cuts += corners.truncated();
+            tileLen += walkLength(from[i], tiles.data(), (int)tiles.size());
+            if (!corners.truncated())
+                cornerLen += walkLength(from[i], &corners[0], corners.size());
+            else
+                cornerLen += walkLength(from[i], tiles.data(), (int)tiles.size());
+        }
+        long allocs = allocations - before;
+        for (int i = 0; i < QUERIES; ++i)
+            if (repath(i) && bodyHitsWall(map, from[i], corners, HUNTER_RADIUS))
+                clipped++;
+        printf("%-8s %10.1f %10.1f %10d %10ld %11.1f%% %10.2f %10.2f %10ld\n", k.name, (double)tileCount / found,
+               (double)cornerCount / found, most, cuts, 100.0 * (1.0 - cornerLen / tileLen), pullMs * 1000.0 / found,
+               (double)allocs / QUERIES, clipped);
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Perception benchmark: a squad of hunters scattered around the player with random facings,
+// asking "can I see the player" and "can I shoot" every frame. Once per hunter the way
+// Hunter::update/tryShoot do it alone (cosf, sqrtf, a ray each), once as one
+// HunterPerception pass (distance cull, SSE cone, then LOS for what's left), with and
+// without the shared VisibilityField. The ray pass must match the hunters alone exactly (exits 1
+// if not). The field pass is only reported, shadowcasting sees corners a bit differently.
+// usage: PerceptionBench [hunters] [size]
+#include "BenchCommon.hpp"
+#include "Hunter.hpp"
+#include "HunterPerception.hpp"
+#include "Tilemap.hpp"
+#include "VisibilityField.hpp"
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    const int hunters = (argc > 1) ? atoi(argv[1]) : 32;
+    const int size = (argc > 2) ? atoi(argv[2]) : 512;
+    const int FRAMES = 2000;
+    const float SPREAD = 900.0f; // some past shootRange, most inside
+
+    Tilemap map(size, size);
+    map.generateCave(41, 45, 5);
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> ang(-PI, PI), near(0.0f, SPREAD);
+
+    // a new spot (and squad around it) every 20 frames, facings turn a bit every frame
+    const int SPOTS = FRAMES / 20;
+    std::vector<Vector2> spot(SPOTS);
+    std::vector<std::vector<Hunter>> squads(SPOTS);
+    for (int s = 0; s < SPOTS; ++s)
+    {
+        spot[s] = map.randomFloorPosition(rng);
+        squads[s].resize(hunters);
+        for (int i = 0; i < hunters; ++i)
+        {
+            Hunter &h = squads[s][i];
+            h.id = i;
+            do
+            {
+                float a = ang(rng), d = near(rng);
+                h.pos = {spot[s].x + cosf(a) * d, spot[s].y + sinf(a) * d};
+            } while (map.isWall((int)floorf(h.pos.x / Tilemap::TILE_SIZE), (int)floorf(h.pos.y / Tilemap::TILE_SIZE)));
+            h.facingRad = ang(rng);
+        }
+    }
+    auto turn = [&](std::vector<Hunter> &squad)
+    {
+        for (Hunter &h : squad)
+            h.facingRad += 0.05f;
+    };
+
+    // alone, what Hunter::update and tryShoot do without a perception pass
+    long seeAlone = 0, shootAlone = 0;
+    std::vector<uint8_t> aloneSee((size_t)FRAMES * hunters), aloneShoot((size_t)FRAMES * hunters);
+    double aloneMs = benchMs([&]
+                             {
+        for (int f = 0; f < FRAMES; ++f)
+        {
+            std::vector<Hunter> &squad = squads[f / 20];
+            Vector2 p = spot[f / 20];
+            for (int i = 0; i < hunters; ++i)
+            {
+                const Hunter &h = squad[i];
+                float dx = p.x - h.pos.x, dy = p.y - h.pos.y;
+                float d = sqrtf(dx * dx + dy * dy);
+                bool see = d <= h.proximityRange || h.canSeePlayerCone(map, p);
+                bool shoot = false;
+                if (d <= h.shootRange && d > 1e-4f)
+                {
+                    float cosHalf = cosf((h.fovDeg * 0.5f) * (PI / 180.0f));
+                    shoot = cosf(h.facingRad) * dx / d + sinf(h.facingRad) * dy / d >= cosHalf && map.hasLineOfSight(h.pos, p);
+                }
+                aloneSee[(size_t)f * hunters + i] = see;
+                aloneShoot[(size_t)f * hunters + i] = shoot;
+                seeAlone += see;
+                shootAlone += shoot;
+            }
+            turn(squad);
+        } });
+
+    long differ[2] = {0, 0};
+    double passMs[2];
+    long rays[2] = {0, 0};
+    for (int useField = 0; useField < 2; ++useField)
+    {
+        // same facings as the first run
+        for (auto &squad : squads)
+            for (Hunter &h : squad)
+                h.facingRad -= 0.05f * 20;
+        HunterPerception perception;
+        VisibilityField field;
+        passMs[useField] = benchMs([&]
+                                   {
+            for (int f = 0; f < FRAMES; ++f)
+            {
+                std::vector<Hunter> &squad = squads[f / 20];
+                Vector2 p = spot[f / 20];
+                if (useField)
+                    field.compute(map, p, 560.0f);
+                perception.update(map, squad, p, useField ? &field : nullptr);
+                rays[useField] += perception.getStats().rays;
+                for (int i = 0; i < hunters; ++i)
+                {
+                    const HunterPerception::Percept *pc = perception.get(i);
+                    differ[useField] += pc->seesPlayer != (bool)aloneSee[(size_t)f * hunters + i] ||
+                                        pc->canShoot != (bool)aloneShoot[(size_t)f * hunters + i];
+                }
+                turn(squad);
+            } });
+    }
+
+    const long checks = (long)FRAMES * hunters;
+    printf("%d hunters on %d, %d frames, %ld hunter checks (%ld see, %ld can shoot)\n", hunters, size, FRAMES, checks,
+           seeAlone, shootAlone);
+    printf("%-22s %12s %12s %12s %10s\n", "method", "us/frame", "ns/hunter", "rays/frame", "differ");
+    printf("%-22s %12.2f %12.1f %12s %10s\n", "each hunter alone", aloneMs * 1000.0 / FRAMES, aloneMs * 1e6 / checks, "-", "-");
+    printf("%-22s %12.2f %12.1f %12.1f %10ld\n", "perception, rays", passMs[0] * 1000.0 / FRAMES, passMs[0] * 1e6 / checks,
+           (double)rays[0] / FRAMES, differ[0]);
+    printf("%-22s %12.2f %12.1f %12.1f %10ld\n", "perception + field", passMs[1] * 1000.0 / FRAMES,
+           passMs[1] * 1e6 / checks, (double)rays[1] / FRAMES, differ[1]);
+    if (differ[0])
+        fprintf(stderr, "perception with rays differs from the hunters alone %ld times\n", differ[0]);
+    return differ[0] ? 1 : 0;
+}
@@ -0,0 +1,134 @@
+// Reachability benchmark: patrol style goals (80-220px from a random floor tile, like
+// Hunter::pickNewPatrolTarget) on a cave with sealed pockets carved into the rock. Shows how
+// many goals get turned away or redirected by FloorComponents, what a query costs, and how
+// much a failed search would have flooded without it. Also carves between pockets and checks
+// the merged regions still match a fresh RegionLabeler pass.
+// usage: ReachabilityBench [size] [queries]
+#include "BenchCommon.hpp"
+#include "Pathfinder.hpp"
+#include "RegionLabeler.hpp"
+#include "Tilemap.hpp"
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// same partition of the floor, whatever the ids are
+static bool matchesFresh(const Tilemap &map)
+{
+    RegionLabeler labeler;
+    std::vector<int> fresh;
+    std::vector<RegionInfo> info;
+    labeler.label(map.data(), map.getWidth(), map.getHeight(), fresh, info);
+    std::unordered_map<int, int> a2b, b2a;
+    const FloorComponents &c = map.getComponents();
+    for (int y = 1; y < map.getHeight() - 1; ++y)
+        for (int x = 1; x < map.getWidth() - 1; ++x)
+        {
+            int a = c.at(x, y), b = fresh[(size_t)y * map.getWidth() + x];
+            if ((a < 0) != (b < 0))
+                return false;
+            if (a < 0)
+                continue;
+            if (a2b.emplace(a, b).first->second != b || b2a.emplace(b, a).first->second != a)
+                return false;
+        }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const int size = (argc > 1) ? atoi(argv[1]) : 256;
+    const int QUERIES = (argc > 2) ? atoi(argv[2]) : 20000;
+
+    Tilemap map(size, size);
+    map.generateCave(11, 45, 5);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> anyPx(2.0f * Tilemap::TILE_SIZE, (size - 2.0f) * Tilemap::TILE_SIZE);
+
+    // sealed pockets: small carves well inside the rock
+    int pockets = 0;
+    for (int tries = 0; tries < 100000 && pockets < size / 8; ++tries)
+    {
+        Vector2 c = {anyPx(rng), anyPx(rng)};
+        int tx, ty;
+        map.worldToTile(c, tx, ty);
+        bool solid = true;
+        for (int y = ty - 3; y <= ty + 3 && solid; ++y)
+            for (int x = tx - 3; x <= tx + 3 && solid; ++x)
+                solid = map.isWall(x, y) && x > 0 && y > 0 && x < size - 1 && y < size - 1;
+        if (!solid)
+            continue;
+        map.carveCircle(c, 40.0f);
+        pockets++;
+    }
+    printf("%dx%d, %d pockets carved, %d regions, components match fresh labels: %s\n", size, size, pockets,
+           map.getComponents().regionCount(), matchesFresh(map) ? "yes" : "NO");
+
+    // how much a failed search used to flood: the whole region the start is in
+    std::vector<int> regionSize(map.getComponents().regionCount() + size * size / 16, 0);
+    for (int y = 0; y < size; ++y)
+        for (int x = 0; x < size; ++x)
+            if (map.getComponents().at(x, y) >= 0)
+                regionSize[map.getComponents().at(x, y)]++;
+
+    Pathfinder strict, redirect;
+    strict.setRedirectTiles(0);
+    strict.setUseClusters(false);
+    redirect.setUseClusters(false);
+    std::vector<Vector2> path;
+    long walls = 0, cutOff = 0, rejected = 0, redirected = 0, wouldFlood = 0;
+    long strictNodes = 0, redirectNodes = 0;
+    double strictMs = 0, redirectMs = 0;
+    std::uniform_real_distribution<float> ang(0.0f, 6.28f), dist(80.0f, 220.0f);
+    for (int q = 0; q < QUERIES; ++q)
+    {
+        // hunters patrol around floor they can stand on, pockets included
+        Vector2 home = map.randomFloorPosition(rng);
+        float a = ang(rng), d = dist(rng);
+        Vector2 goal = {home.x + cosf(a) * d, home.y + sinf(a) * d};
+        int sx, sy, gx, gy;
+        map.worldToTile(home, sx, sy);
+        map.worldToTile(goal, gx, gy);
+        bool wall = map.isWall(gx, gy);
+        bool apart = !wall && !map.getComponents().connected(sx, sy, gx, gy);
+        walls += wall;
+        cutOff += apart;
+        if (apart)
+            wouldFlood += regionSize[map.getComponents().at(sx, sy)];
+
+        bool ok = false;
+        strictMs += benchMs([&]
+                            { ok = strict.findPath(map, home, goal, path); });
+        strictNodes += strict.lastExpanded();
+        rejected += !ok;
+        redirectMs += benchMs([&]
+                              { ok = redirect.findPath(map, home, goal, path); });
+        redirectNodes += redirect.lastExpanded();
+        redirected += ok && redirect.lastRedirected();
+    }
+    printf("%d patrol goals: %ld in walls, %ld in another region (a search would have closed %.0f tiles each)\n",
+           QUERIES, walls, cutOff, cutOff ? (double)wouldFlood / cutOff : 0.0);
+    printf("%-10s %12s %12s %12s\n", "redirect", "avg us", "avg nodes", "outcome");
+    printf("%-10s %12.2f %12.1f %9ld rejected\n", "off", strictMs * 1000.0 / QUERIES, (double)strictNodes / QUERIES, rejected);
+    printf("%-10s %12.2f %12.1f %9ld redirected\n", "6 tiles", redirectMs * 1000.0 / QUERIES, (double)redirectNodes / QUERIES,
+           redirected);
+
+    // join pockets to the cave and check the merges
+    int checks = 0, good = 0;
+    double carveMs = 0;
+    for (int i = 0; i < 200; ++i)
+    {
+        Vector2 c = {anyPx(rng), anyPx(rng)};
+        carveMs += benchMs([&]
+                           { map.carveCircle(c, 90.0f); });
+        if (i % 20 == 19)
+        {
+            checks++;
+            good += matchesFresh(map);
+        }
+    }
+    printf("200 carves: %.3f ms avg, %ld merges, %d regions left, %d/%d checks match fresh labels\n", carveMs / 200,
+           map.getComponents().mergeCount(), map.getComponents().regionCount(), good, checks);
+    return 0;
+}
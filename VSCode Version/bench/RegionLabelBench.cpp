@@ -0,0 +1,118 @@
+// Region labelling benchmark: union-find scanline labelling against a reference BFS flood fill
+// on smoothed random caves. Checks labels, sizes and bounding boxes match exactly.
+// usage: RegionLabelBench [size ...]
+#include "BenchCommon.hpp"
+#include "BitGrid.hpp"
+#include "RegionLabeler.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <queue>
+#include <random>
+#include <vector>
+
+// the flood fill generateCave used to run (with the skip test fixed)
+static int labelBfs(const std::vector<uint8_t> &cells, int W, int H, std::vector<int> &labels, std::vector<RegionInfo> &regions)
+{
+    labels.assign((size_t)W * H, -1);
+    regions.clear();
+    static const int DIRS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    for (int y = 1; y < H - 1; ++y)
+    {
+        for (int x = 1; x < W - 1; ++x)
+        {
+            if (cells[(size_t)y * W + x] || labels[(size_t)y * W + x] != -1)
+                continue;
+            int id = (int)regions.size();
+            RegionInfo r;
+            r.minX = r.maxX = x;
+            r.minY = r.maxY = y;
+            std::queue<std::pair<int, int>> q;
+            q.push({x, y});
+            labels[(size_t)y * W + x] = id;
+            while (!q.empty())
+            {
+                auto [cx, cy] = q.front();
+                q.pop();
+                r.size++;
+                r.minX = std::min(r.minX, cx);
+                r.maxX = std::max(r.maxX, cx);
+                r.minY = std::min(r.minY, cy);
+                r.maxY = std::max(r.maxY, cy);
+                for (auto &d : DIRS)
+                {
+                    int nx = cx + d[0], ny = cy + d[1];
+                    if (nx <= 0 || ny <= 0 || nx >= W - 1 || ny >= H - 1)
+                        continue;
+                    int &tag = labels[(size_t)ny * W + nx];
+                    if (cells[(size_t)ny * W + nx] || tag != -1)
+                        continue;
+                    tag = id;
+                    q.push({nx, ny});
+                }
+            }
+            regions.push_back(r);
+        }
+    }
+    return (int)regions.size();
+}
+
+static bool sameRegions(const std::vector<RegionInfo> &a, const std::vector<RegionInfo> &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a[i].size != b[i].size || a[i].minX != b[i].minX || a[i].minY != b[i].minY ||
+            a[i].maxX != b[i].maxX || a[i].maxY != b[i].maxY)
+            return false;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<int> sizes = {100, 1024, 4096};
+    if (argc > 1)
+    {
+        sizes.clear();
+        for (int i = 1; i < argc; ++i)
+            sizes.push_back(atoi(argv[i]));
+    }
+
+    printf("%-6s %6s %10s %10s %10s %8s %s\n", "size", "fill%", "regions", "bfs ms", "uf ms", "speedup", "match");
+    for (int n : sizes)
+    {
+        for (int fill : {40, 45, 50})
+        {
+            // smoothed random cave, before any cleanup
+            std::mt19937 rng(99 + fill);
+            std::uniform_int_distribution<int> d100(0, 99);
+            std::vector<uint8_t> cells((size_t)n * n);
+            for (int y = 0; y < n; ++y)
+                for (int x = 0; x < n; ++x)
+                    cells[(size_t)y * n + x] = (x == 0 || y == 0 || x == n - 1 || y == n - 1) ? 1 : (d100(rng) < fill);
+            BitGrid cur, next;
+            cur.fromBytes(cells.data(), n, n);
+            for (int s = 0; s < 5; ++s)
+            {
+                smoothCaveBits(cur, next, 1);
+                std::swap(cur, next);
+            }
+            cur.toBytes(cells.data());
+
+            std::vector<int> bfsLabels, ufLabels;
+            std::vector<RegionInfo> bfsRegions, ufRegions;
+            RegionLabeler labeler;
+            int count = 0;
+            double bfsMs = benchMs([&]
+                                   { count = labelBfs(cells, n, n, bfsLabels, bfsRegions); });
+            labeler.label(cells.data(), n, n, ufLabels, ufRegions); // warm the reused buffers
+            double ufMs = benchMs([&]
+                                  { labeler.label(cells.data(), n, n, ufLabels, ufRegions); });
+
+            bool match = (bfsLabels == ufLabels) && sameRegions(bfsRegions, ufRegions);
+            printf("%-6d %6d %10d %10.2f %10.2f %7.1fx %s\n", n, fill, count, bfsMs, ufMs, bfsMs / ufMs, match ? "yes" : "NO");
+            if (!match)
+                return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+// Spatial hash benchmark: a crowd of animals and hunters spread over the cave, and a frame's
+// worth of the queries the game makes (bullets against hunters, bites, boulders against both,
+// friendly fire lines), by scanning the vectors like main/Player/Boulder used to and through
+// SpatialHash. The hash time includes building it and moving everything once, like a tick.
+// Checks both find the same entities.
+// usage: SpatialHashBench [animals] [hunters] [size]
+#include "BenchCommon.hpp"
+#include "SpatialHash.hpp"
+#include "Tilemap.hpp"
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+struct Body
+{
+    Vector2 pos;
+    float radius;
+};
+
+int main(int argc, char **argv)
+{
+    const int animals = (argc > 1) ? atoi(argv[1]) : 4000;
+    const int hunters = (argc > 2) ? atoi(argv[2]) : 400;
+    const int size = (argc > 3) ? atoi(argv[3]) : 512;
+    const int FRAMES = 200;
+    const int BULLETS = 200, BITES = 4, BOULDERS = 8, LINES = 100; // a busy frame
+
+    Tilemap map(size, size);
+    map.generateCave(43, 45, 5);
+    std::mt19937 rng(3);
+    std::vector<Body> a(animals), h(hunters);
+    for (Body &b : a)
+        b = {map.randomFloorPosition(rng), 10.0f}; // Animal::radius
+    for (Body &b : h)
+        b = {map.randomFloorPosition(rng), 12.0f}; // Hunter::radius
+    std::uniform_real_distribution<float> jitter(-2.0f, 2.0f), ang(-PI, PI), range(0.0f, 600.0f);
+
+    // queries near the action, around random hunters
+    struct Query
+    {
+        Vector2 p, q;
+    };
+    std::vector<Query> bullets, bites, boulders, lines;
+    auto around = [&](int count, std::vector<Query> &out)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            Vector2 c = h[rng() % hunters].pos;
+            float t = ang(rng), d = range(rng);
+            out.push_back({{c.x + jitter(rng) * 20, c.y + jitter(rng) * 20}, {c.x + cosf(t) * d, c.y + sinf(t) * d}});
+        }
+    };
+    around(BULLETS, bullets);
+    around(BITES, bites);
+    around(BOULDERS, boulders);
+    around(LINES, lines);
+
+    auto segDist2 = [](Vector2 a, Vector2 b, Vector2 p)
+    {
+        Vector2 ab{b.x - a.x, b.y - a.y}, ap{p.x - a.x, p.y - a.y};
+        float ab2 = ab.x * ab.x + ab.y * ab.y;
+        float t = ab2 < 1e-8f ? 0.0f : fminf(1.0f, fmaxf(0.0f, (ap.x * ab.x + ap.y * ab.y) / ab2));
+        float dx = p.x - (a.x + ab.x * t), dy = p.y - (a.y + ab.y * t);
+        return dx * dx + dy * dy;
+    };
+    const float biteRange = 28.0f, cosBite = cosf(45.0f * (PI / 180.0f)), boulderR = 16.0f, safety = 20.0f;
+
+    // what the old loops did, summing indices found so the two sides can be compared
+    long scanSum = 0, scanHits = 0;
+    double scanMs = benchMs([&]
+                            {
+        for (int f = 0; f < FRAMES; ++f)
+        {
+            for (const Query &q : bullets)
+                for (int i = 0; i < hunters; ++i)
+                {
+                    float dx = h[i].pos.x - q.p.x, dy = h[i].pos.y - q.p.y, rr = h[i].radius + 4.0f;
+                    if (dx * dx + dy * dy <= rr * rr)
+                        scanSum += i, scanHits++;
+                }
+            for (const Query &q : bites)
+            {
+                Vector2 fwd{q.q.x - q.p.x, q.q.y - q.p.y};
+                float L = sqrtf(fwd.x * fwd.x + fwd.y * fwd.y);
+                fwd = {fwd.x / L, fwd.y / L};
+                for (const std::vector<Body> *v : {&a, &h})
+                    for (int i = 0; i < (int)v->size(); ++i)
+                    {
+                        const Body &b = (*v)[i];
+                        float dx = b.pos.x - q.p.x, dy = b.pos.y - q.p.y, d = sqrtf(dx * dx + dy * dy);
+                        if (d <= biteRange + b.radius && d > 1e-4f && (fwd.x * dx + fwd.y * dy) / d >= cosBite)
+                            scanSum += i, scanHits++;
+                    }
+            }
+            for (const Query &q : boulders)
+                for (const std::vector<Body> *v : {&a, &h})
+                    for (int i = 0; i < (int)v->size(); ++i)
+                    {
+                        const Body &b = (*v)[i];
+                        float dx = b.pos.x - q.p.x, dy = b.pos.y - q.p.y, rr = boulderR + b.radius;
+                        if (dx * dx + dy * dy <= rr * rr)
+                            scanSum += i, scanHits++;
+                    }
+            for (const Query &q : lines)
+                for (int i = 0; i < hunters; ++i)
+                    if (segDist2(q.p, q.q, h[i].pos) <= safety * safety)
+                        scanSum += i, scanHits++;
+        } });
+
+    long hashSum = 0, hashHits = 0;
+    SpatialHash ah, hh;
+    double buildMs = 0.0;
+    double hashMs = benchMs([&]
+                            {
+        for (int f = 0; f < FRAMES; ++f)
+        {
+            buildMs += benchMs([&]
+                               {
+                ah.build(a);
+                hh.build(h);
+                for (int i = 0; i < hunters; ++i)
+                    hh.move(i, h[i].pos);
+                for (int i = 0; i < animals; ++i)
+                    ah.move(i, a[i].pos); });
+            auto count = [&](int i)
+            {
+                hashSum += i;
+                hashHits++;
+            };
+            for (const Query &q : bullets)
+                hh.circle(q.p, 4.0f, count);
+            for (const Query &q : bites)
+            {
+                Vector2 fwd{q.q.x - q.p.x, q.q.y - q.p.y};
+                float L = sqrtf(fwd.x * fwd.x + fwd.y * fwd.y);
+                fwd = {fwd.x / L, fwd.y / L};
+                ah.sector(q.p, biteRange, fwd, cosBite, count);
+                hh.sector(q.p, biteRange, fwd, cosBite, count);
+            }
+            for (const Query &q : boulders)
+            {
+                ah.circle(q.p, boulderR, count);
+                hh.circle(q.p, boulderR, count);
+            }
+            for (const Query &q : lines)
+                hh.segment(q.p, q.q, safety, [&](int i)
+                           {
+                    if (segDist2(q.p, q.q, h[i].pos) <= safety * safety)
+                        count(i); });
+        } });
+
+    printf("%d animals, %d hunters on %d, %d frames of %d bullets %d bites %d boulders %d lines\n", animals, hunters, size,
+           FRAMES, BULLETS, BITES, BOULDERS, LINES);
+    printf("%-22s %12s %12s\n", "method", "us/frame", "hits/frame");
+    printf("%-22s %12.1f %12.1f\n", "scan the vectors", scanMs * 1000.0 / FRAMES, (double)scanHits / FRAMES);
+    printf("%-22s %12.1f %12.1f   (%.1f us of it building/moving)\n", "spatial hash", hashMs * 1000.0 / FRAMES,
+           (double)hashHits / FRAMES, buildMs * 1000.0 / FRAMES);
+    printf("hash memory %zu bytes, results %s\n", ah.memoryBytes() + hh.memoryBytes(),
+           (scanSum == hashSum && scanHits == hashHits) ? "match" : "DIFFER");
+    return 0;
+}
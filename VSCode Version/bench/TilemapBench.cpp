@@ -0,0 +1,79 @@
+// Tilemap size benchmark: memory use and cave generation time at 100^2, 1024^2 and 4096^2.
+// Also what the floor region index costs on a generated cave, against an int label per tile
+// usage: TilemapBench [size ...]
+#include "BenchCommon.hpp"
+#include "Tilemap.hpp"
+#include "Pathfinder.hpp"
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    std::vector<int> sizes = {100, 1024, 4096};
+    if (argc > 1)
+    {
+        sizes.clear();
+        for (int i = 1; i < argc; ++i)
+            sizes.push_back(atoi(argv[i]));
+    }
+
+    printf("%-6s %12s %14s %12s %12s %12s %14s %14s %10s %12s %14s\n", "size", "tiles MiB", "int[][] MiB", "gen ms",
+           "graph ms", "isWall ns", "findPath ms", "w/ scratch MiB", "runs", "regions KiB", "per tile KiB");
+    for (int n : sizes)
+    {
+        Tilemap map(n, n);
+        size_t tileBytes = map.memoryBytes();
+        size_t oldBytes = (size_t)n * n * sizeof(int); // the old inline int map[H][W]
+
+        // generation, a few seeds on small maps
+        int runs = (n <= 256) ? 20 : (n <= 1024 ? 3 : 1);
+        double genMs = 0.0;
+        for (int r = 0; r < runs; ++r)
+            genMs += benchMs([&]
+                             { map.generateCave(1000 + r, 45, 5); });
+        genMs /= runs;
+
+        // the cluster graph is built by the first long path, once per cave
+        double graphMs = benchMs([&]
+                                 { map.getClusterGraph(); });
+
+        // isWall sweep over the whole map
+        volatile int walls = 0;
+        int reps = std::max(1, 50000000 / (n * n));
+        double wallMs = benchMs([&]
+                                {
+            int w = 0;
+            for (int r = 0; r < reps; ++r)
+                for (int y = 0; y < n; ++y)
+                    for (int x = 0; x < n; ++x)
+                        w += map.isWall(x, y);
+            walls = w; });
+        double nsPerWall = wallMs * 1e6 / ((double)reps * n * n);
+
+        // a handful of paths between random floor tiles (first one sizes the scratch)
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> d(1, n - 2);
+        std::vector<Vector2> floors;
+        while ((int)floors.size() < 64)
+        {
+            int x = d(rng), y = d(rng);
+            if (!map.isWall(x, y))
+                floors.push_back(map.tileToWorldCenter(x, y));
+        }
+        std::vector<Vector2> path;
+        int queries = 32;
+        double pathMs = benchMs([&]
+                                {
+            for (int q = 0; q < queries; ++q)
+                map.findPath(floors[q], floors[q + 32], path); }) /
+                        queries;
+
+        const FloorComponents &regions = map.getComponents();
+        printf("%-6d %12.2f %14.2f %12.2f %12.2f %12.3f %14.3f %14.2f %10d %12.1f %14.1f\n", n, toMiB(tileBytes), toMiB(oldBytes),
+               genMs, graphMs, nsPerWall, pathMs, toMiB(map.memoryBytes() + Pathfinder::forThread().memoryBytes()),
+               regions.runCount(), regions.memoryBytes() / 1024.0, oldBytes / 1024.0);
+        (void)walls;
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+// Visibility field benchmark: every hunter in range asking "can I see the player" each
+// frame, once as a ray per hunter (Tilemap::hasLineOfSight) and once as one shadowcast from
+// the player plus a lookup per hunter. The player moves a few px a frame so most frames land
+// on the same tile as the last one. Counts where the two answers differ (shadowcasting sees
+// around corners a bit differently from Bresenham) and checks the field is symmetric, exits 1
+// if it isn't.
+// usage: VisibilityFieldBench [hunters] [size]
+#include "BenchCommon.hpp"
+#include "Tilemap.hpp"
+#include "VisibilityField.hpp"
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    const int hunters = (argc > 1) ? atoi(argv[1]) : 32;
+    const int size = (argc > 2) ? atoi(argv[2]) : 512;
+    const int FRAMES = 3000;
+    const float SIGHT = 520.0f;          // Hunter::sightRange
+    const float STEP = 180.0f / 60.0f;   // Player::speed at 60 fps
+    const int SPOTS = 100;               // player spots, FRAMES / SPOTS frames walking from each
+
+    Tilemap map(size, size);
+    map.generateCave(37, 45, 5);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> ang(0.0f, 6.28f), near(0.0f, SIGHT);
+
+    // spots for the player, each with hunters scattered around it within sight range
+    std::vector<Vector2> spot(SPOTS), heading(SPOTS);
+    std::vector<std::vector<Vector2>> around(SPOTS);
+    for (int s = 0; s < SPOTS; ++s)
+    {
+        spot[s] = map.randomFloorPosition(rng);
+        float t = ang(rng);
+        heading[s] = {cosf(t) * STEP, sinf(t) * STEP};
+        while ((int)around[s].size() < hunters)
+        {
+            float a = ang(rng), d = near(rng);
+            Vector2 h{spot[s].x + cosf(a) * d, spot[s].y + sinf(a) * d};
+            int tx, ty;
+            map.worldToTile(h, tx, ty);
+            if (!map.isWall(tx, ty))
+                around[s].push_back(h);
+        }
+    }
+    auto playerAt = [&](int frame)
+    {
+        int s = frame / (FRAMES / SPOTS), k = frame % (FRAMES / SPOTS);
+        Vector2 p{spot[s].x + heading[s].x * k, spot[s].y + heading[s].y * k};
+        int tx, ty;
+        map.worldToTile(p, tx, ty);
+        return map.isWall(tx, ty) ? spot[s] : p; // stay put rather than walk into rock
+    };
+
+    long seenRay = 0, seenField = 0, checks = 0, differ = 0;
+    double rayMs = benchMs([&]
+                           {
+        for (int f = 0; f < FRAMES; ++f)
+        {
+            Vector2 p = playerAt(f);
+            for (const Vector2 &h : around[f / (FRAMES / SPOTS)])
+                seenRay += map.hasLineOfSight(h, p);
+        } });
+
+    VisibilityField field;
+    double fieldMs = benchMs([&]
+                             {
+        for (int f = 0; f < FRAMES; ++f)
+        {
+            field.compute(map, playerAt(f), SIGHT);
+            for (const Vector2 &h : around[f / (FRAMES / SPOTS)])
+                seenField += field.visible(map, h);
+        } });
+
+    for (int f = 0; f < FRAMES; ++f)
+    {
+        Vector2 p = playerAt(f);
+        field.compute(map, p, SIGHT);
+        for (const Vector2 &h : around[f / (FRAMES / SPOTS)])
+        {
+            differ += field.visible(map, h) != map.hasLineOfSight(h, p);
+            checks++;
+        }
+    }
+
+    // symmetry: every floor tile the player's tile sees must see the player's tile back
+    long pairs = 0, asymmetric = 0;
+    VisibilityField back;
+    for (int s = 0; s < SPOTS; s += 10)
+    {
+        field.compute(map, spot[s], SIGHT);
+        const int r = field.radiusTiles();
+        for (int ty = field.originY() - r; ty <= field.originY() + r; ty += 3)
+            for (int tx = field.originX() - r; tx <= field.originX() + r; tx += 3)
+            {
+                if (map.isWall(tx, ty) || !field.visibleTile(tx, ty))
+                    continue;
+                back.compute(map, map.tileToWorldCenter(tx, ty), SIGHT);
+                asymmetric += !back.visibleTile(field.originX(), field.originY());
+                pairs++;
+            }
+    }
+
+    const VisibilityField::Stats &st = field.getStats();
+    printf("%d hunters on %d, %d frames, %ld checks\n", hunters, size, FRAMES, checks);
+    printf("%-22s %12s %12s %10s\n", "method", "us/frame", "ns/check", "seen");
+    printf("%-22s %12.2f %12.1f %10ld\n", "ray per hunter", rayMs * 1000.0 / FRAMES, rayMs * 1e6 / checks, seenRay);
+    printf("%-22s %12.2f %12.1f %10ld\n", "field + lookups", fieldMs * 1000.0 / FRAMES, fieldMs * 1e6 / checks, seenField);
+    printf("field: %.1f us a fresh compute, %d tiles lit, %zu bytes\n", st.msLastCompute * 1000.0, st.tilesLastCompute,
+           field.memoryBytes());
+    printf("answers differing from the ray: %ld (%.2f%%)\n", differ, 100.0 * differ / checks);
+    printf("symmetry: %ld pairs, %ld one way only\n", pairs, asymmetric);
+    if (asymmetric)
+        fprintf(stderr, "field isn't symmetric: %ld tiles seen one way only\n", asymmetric);
+    return asymmetric ? 1 : 0;
+}
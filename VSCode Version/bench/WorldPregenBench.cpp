@@ -0,0 +1,65 @@
+// World pre-generation benchmark: builds a list of seeds one at a time with buildWorld and again
+// with buildBatch, checks every batch world matches its serial twin and reports the speedup.
+// usage: WorldPregenBench [seeds] [threads]
+#include "BenchCommon.hpp"
+#include "WorldPregen.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static bool sameVec(Vector2 a, Vector2 b) { return a.x == b.x && a.y == b.y; }
+
+// tiles, spawns and what every animal and hunter starts with
+static bool sameWorld(const PreparedWorld &a, const PreparedWorld &b)
+{
+    const Tilemap &ma = a.map, &mb = b.map;
+    if (a.seed != b.seed || ma.getWidth() != mb.getWidth() || ma.getHeight() != mb.getHeight())
+        return false;
+    if (memcmp(ma.data(), mb.data(), (size_t)ma.getWidth() * ma.getHeight()) != 0)
+        return false;
+    if (!sameVec(a.playerSpawn, b.playerSpawn) || a.animals.size() != b.animals.size() || a.hunters.size() != b.hunters.size())
+        return false;
+    for (size_t i = 0; i < a.animals.size(); ++i)
+    {
+        const Animal &x = a.animals[i], &y = b.animals[i];
+        if (!sameVec(x.pos, y.pos) || !sameVec(x.target, y.target) || x.radius != y.radius || x.roam != y.roam)
+            return false;
+    }
+    for (size_t i = 0; i < a.hunters.size(); ++i)
+        if (!sameVec(a.hunters[i].pos, b.hunters[i].pos) || !sameVec(a.hunters[i].patrolHome, b.hunters[i].patrolHome))
+            return false;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int count = (argc > 1) ? atoi(argv[1]) : 16;
+    int threads = (argc > 2) ? atoi(argv[2]) : 0;
+
+    WorldSpec spec;
+    std::vector<unsigned> seeds;
+    for (int i = 0; i < count; ++i)
+        seeds.push_back(1000u + 7u * i);
+
+    std::vector<PreparedWorld> serial;
+    double serialMs = benchMs([&]
+                              {
+        for (unsigned s : seeds)
+            serial.push_back(WorldPregen::buildWorld(spec, s)); });
+
+    std::vector<PreparedWorld> batch;
+    double batchMs = benchMs([&]
+                             { batch = WorldPregen::buildBatch(spec, seeds, threads); });
+
+    int mismatches = 0;
+    for (size_t i = 0; i < seeds.size(); ++i)
+        if (i >= batch.size() || !sameWorld(serial[i], batch[i]))
+        {
+            fprintf(stderr, "seed %u: batch world differs from buildWorld\n", seeds[i]);
+            mismatches++;
+        }
+
+    printf("%d worlds %dx%d: buildWorld %.1f ms, buildBatch %.1f ms (%.2fx), %d mismatches\n", count, spec.width,
+           spec.height, serialMs, batchMs, batchMs > 0.0 ? serialMs / batchMs : 0.0, mismatches);
+    return mismatches ? 1 : 0;
+}
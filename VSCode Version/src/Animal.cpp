@@ -4,30 +4,47 @@
 static inline float len2(Vector2 v) { return v.x * v.x + v.y * v.y; }
 static inline float clampf(float v, float a, float b) { return v < a ? a : (v > b ? b : v); }
 
-void Animal::randomise(const Tilemap &world)
+void Animal::randomise(const Tilemap &world, std::mt19937 &rng, const FloorQuery &rule)
 {
-    pos = world.randomFloorPosition();
-    home = pos;
+    auto rand = [&](int lo, int hi)
+    { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+    auto pick = [&]
+    {
+        Vector2 spawn;
+        if (!world.randomFloorPosition(rng, rule, spawn))
+            spawn = world.randomFloorPosition(rng); // rules can't be met, anywhere will do
+        return spawn;
+    };
 
     // varying size and speed per creature
-    radius = (float)GetRandomValue(6, 18);
+    radius = (float)rand(6, 18);
+
+    // collides at full size, so the big ones need a spot clear of rock (they'd never slide
+    // free of an overlap). anything under half a tile fits on any floor tile's centre
+    pos = pick();
+    for (int tries = 0; tries < 16 && world.circleHitsWall(pos, radius); ++tries)
+        pos = pick();
+    if (world.circleHitsWall(pos, radius))
+        radius = Tilemap::TILE_SIZE * 0.5f - 2.0f;
+    home = pos;
+
     speed = clampf(140 - (radius * 4.0f), 40.0f, 120.0f); // bigger creatures are slower
-    roam = (float)GetRandomValue(120, 240);
+    roam = (float)rand(120, 240);
 
     // color palette
     Color cols[] = {
         Color{220, 180, 60, 255}, Color{120, 200, 160, 255},
         Color{200, 120, 160, 255}, Color{180, 200, 80, 255}};
-    color = cols[GetRandomValue(0, 3)];
+    color = cols[rand(0, 3)];
 
     // pick first target near home
-    float a = GetRandomValue(0, 628) / 100.0f;
-    float r = (float)GetRandomValue(30, (int)roam);
-    target = {home.x + cosf(a) * r, home.y + sinf(a) * r};
-    retargetTimer = (float)GetRandomValue(60, 180) / 60.0f;
+    float ang = rand(0, 628) / 100.0f;
+    float r = (float)rand(30, (int)roam);
+    target = {home.x + cosf(ang) * r, home.y + sinf(ang) * r};
+    retargetTimer = (float)rand(60, 180) / 60.0f;
 }
 
-void Animal::update(float dt, const Tilemap &world)
+Vector2 Animal::steer(float dt)
 {
     retargetTimer -= dt;
 
@@ -55,17 +72,7 @@ void Animal::update(float dt, const Tilemap &world)
     float len = sqrtf(toTarget.x * toTarget.x + toTarget.y * toTarget.y);
     Vector2 dir = len > 0.001f ? Vector2{toTarget.x / len, toTarget.y / len} : Vector2{0, 0};
 
-    Vector2 delta = {dir.x * speed * dt, dir.y * speed * dt};
-
-    Vector2 next = {pos.x + delta.x, pos.y + delta.y};
-    int tx = (int)(next.x / Tilemap::TILE_SIZE), ty = (int)(next.y / Tilemap::TILE_SIZE);
-    if (!world.isWall(tx, ty))
-        pos = next;
-    else
-    {
-        // if hitting a wall, force new target
-        retargetTimer = 0.0f;
-    }
+    return {dir.x * speed * dt, dir.y * speed * dt};
 }
 
 void Animal::draw() const
@@ -1,5 +1,6 @@
 #pragma once
 #include <raylib.h>
+#include <random>
 #include "Tilemap.hpp"
 
 struct Animal
@@ -16,7 +17,12 @@ struct Animal
 
     bool alive = true;
 
-    void randomise(const Tilemap &world);
-    void update(float dt, const Tilemap &world);
+    // spawn spot, size, colour and first target all come from rng, so a seed always gives the
+    // same animals (WorldPregen builds them on worker threads)
+    void randomise(const Tilemap &world, std::mt19937 &rng, const FloorQuery &rule);
+    // the wandering on its own: picks targets and returns this tick's move, for resolving
+    // lots of animals at once (Tilemap::resolveCollisions). hitWall() if it got blocked
+    Vector2 steer(float dt);
+    void hitWall() { retargetTimer = 0.0f; }
     void draw() const;
 };
\ No newline at end of file
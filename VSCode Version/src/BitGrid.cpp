@@ -0,0 +1,124 @@
+#include "BitGrid.hpp"
+#include <algorithm>
+#include <thread>
+
+void BitGrid::fromBytes(const uint8_t *cells, int w, int h)
+{
+    resize(w, h);
+    for (int y = 0; y < h; ++y)
+    {
+        const uint8_t *src = cells + (size_t)y * w;
+        uint64_t *dst = row(y);
+        for (int x = 0; x < w; ++x)
+            dst[x >> 6] |= (uint64_t)(src[x] != 0) << (x & 63);
+    }
+}
+
+void BitGrid::toBytes(uint8_t *cells) const
+{
+    for (int y = 0; y < height; ++y)
+    {
+        const uint64_t *src = row(y);
+        uint8_t *dst = cells + (size_t)y * width;
+        for (int x = 0; x < width; ++x)
+            dst[x] = (uint8_t)((src[x >> 6] >> (x & 63)) & 1u);
+    }
+}
+
+// adders on 64 lanes at once
+static inline void fullAdd(uint64_t a, uint64_t b, uint64_t c, uint64_t &sum, uint64_t &carry)
+{
+    uint64_t ab = a ^ b;
+    sum = ab ^ c;
+    carry = (a & b) | (c & ab);
+}
+
+static void smoothRows(const BitGrid &src, BitGrid &dst, int y0, int y1)
+{
+    const int W = src.wordsPerRow;
+    // bits inside the map in the last word, padding stays 0
+    const int tailBits = src.width & 63;
+    const uint64_t lastMask = tailBits ? ((1ull << tailBits) - 1) : ~0ull;
+    const int lastX = src.width - 1;
+
+    for (int y = y0; y < y1; ++y)
+    {
+        uint64_t *out = dst.row(y);
+        if (y == 0 || y == src.height - 1)
+        {
+            // top and bottom rows are always wall
+            std::fill(out, out + W, ~0ull);
+            out[W - 1] &= lastMask;
+            continue;
+        }
+
+        const uint64_t *up = src.row(y - 1);
+        const uint64_t *mid = src.row(y);
+        const uint64_t *down = src.row(y + 1);
+
+        for (int w = 0; w < W; ++w)
+        {
+            // west neighbour of bit i is bit i-1, so shift left and pull in the previous word's top bit
+            auto west = [&](const uint64_t *r)
+            { return (r[w] << 1) | (w > 0 ? r[w - 1] >> 63 : 0); };
+            auto east = [&](const uint64_t *r)
+            { return (r[w] >> 1) | (w + 1 < W ? r[w + 1] << 63 : 0); };
+
+            uint64_t n = up[w], s = down[w];
+            uint64_t nw = west(up), ne = east(up);
+            uint64_t wv = west(mid), ev = east(mid);
+            uint64_t sw = west(down), se = east(down);
+
+            // count the 8 neighbours into 4 bit planes (1, 2, 4, 8)
+            uint64_t s1, c1, s2, c2, b0, c4;
+            fullAdd(nw, n, ne, s1, c1);
+            fullAdd(wv, ev, sw, s2, c2);
+            uint64_t s3 = s ^ se, c3 = s & se;
+            fullAdd(s1, s2, s3, b0, c4);
+
+            uint64_t t1, d1;
+            fullAdd(c1, c2, c3, t1, d1);
+            uint64_t b1 = t1 ^ c4, d2 = t1 & c4;
+            uint64_t b2 = d1 ^ d2, b3 = d1 & d2;
+
+            // n > 4 -> wall, n == 4 -> keep, n < 4 -> floor
+            uint64_t gt4 = b3 | (b2 & (b1 | b0));
+            uint64_t eq4 = b2 & ~b1 & ~b0 & ~b3;
+            out[w] = gt4 | (eq4 & mid[w]);
+        }
+
+        // left and right columns are always wall
+        out[0] |= 1ull;
+        out[lastX >> 6] |= 1ull << (lastX & 63);
+        out[W - 1] &= lastMask;
+    }
+}
+
+void smoothCaveBits(const BitGrid &src, BitGrid &dst, int threads)
+{
+    if (dst.width != src.width || dst.height != src.height)
+        dst.resize(src.width, src.height);
+
+    if (threads <= 0)
+        threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    // not worth a thread for less than ~64 rows each
+    threads = std::min(threads, std::max(1, src.height / 64));
+
+    if (threads == 1)
+    {
+        smoothRows(src, dst, 0, src.height);
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    int band = (src.height + threads - 1) / threads;
+    for (int t = 0; t < threads; ++t)
+    {
+        int y0 = t * band, y1 = std::min(src.height, y0 + band);
+        if (y0 >= y1)
+            break;
+        pool.emplace_back(smoothRows, std::cref(src), std::ref(dst), y0, y1);
+    }
+    for (auto &th : pool)
+        th.join();
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/*
+Grid of bits packed 64 to a word, each row padded to a whole number of words.
+Bit x of a row lives in word x/64 at bit x%64, padding bits past width stay 0.
+Used for the bit-parallel cave smoothing.
+*/
+struct BitGrid
+{
+    int width = 0;
+    int height = 0;
+    int wordsPerRow = 0;
+    std::vector<uint64_t> words;
+
+    void resize(int w, int h)
+    {
+        width = w;
+        height = h;
+        wordsPerRow = (w + 63) / 64;
+        words.assign((size_t)wordsPerRow * h, 0);
+    }
+
+    uint64_t *row(int y) { return &words[(size_t)y * wordsPerRow]; }
+    const uint64_t *row(int y) const { return &words[(size_t)y * wordsPerRow]; }
+
+    bool get(int x, int y) const { return (row(y)[x >> 6] >> (x & 63)) & 1u; }
+    void set(int x, int y, bool v)
+    {
+        uint64_t bit = 1ull << (x & 63);
+        if (v)
+            row(y)[x >> 6] |= bit;
+        else
+            row(y)[x >> 6] &= ~bit;
+    }
+
+    // byte grid (one byte per tile, nonzero = set) <-> bits
+    void fromBytes(const uint8_t *cells, int w, int h);
+    void toBytes(uint8_t *cells) const;
+};
+
+/*
+One cave smoothing pass over packed rows, bit-identical to the scalar rule in Tilemap:
+border cells become wall, interior cells with more than 4 wall neighbours become wall,
+fewer than 4 become floor and exactly 4 stay as they are.
+Neighbours are counted 64 cells at a time with a bitwise adder tree.
+threads > 1 splits the rows into bands (0 = one per hardware thread).
+*/
+void smoothCaveBits(const BitGrid &src, BitGrid &dst, int threads = 1);
@@ -6,6 +6,7 @@
 
 class Hunter;
 class Player;
+class SpatialHash;
 
 struct Boulder
 {
@@ -15,7 +16,8 @@ struct Boulder
     float life = 2.0f;
     bool alive = true;
 
-    bool update(float dt, const Tilemap &world, std::vector<Animal> &animals, std::vector<Hunter> &hunters, const Player &player);
+    bool update(float dt, const Tilemap &world, std::vector<Animal> &animals, std::vector<Hunter> &hunters, const Player &player,
+                const SpatialHash &animalHash, const SpatialHash &hunterHash);
 
     void draw() const
     {
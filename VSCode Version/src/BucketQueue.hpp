@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/*
+Priority queue for small integer keys that only ever go up (A* f with a consistent
+heuristic, Dijkstra distances). A ring of buckets, one per key, from the smallest key
+still queued; pop takes from the first non-empty bucket, so push and pop are O(1) apart
+from stepping over empty keys.
+
+Buckets are linked lists threaded through one item pool, so memory only depends on how
+many pushes a search makes and not on which keys they land on. The ring doubles when a
+key lands further ahead than it covers. clear() keeps both, so once they've grown to the
+biggest search nothing is allocated.
+
+Order: smallest key first, and among equal keys the last one pushed (LIFO, which for A*
+means the deeper of two equal-f nodes). A key below the smallest one still queued is
+taken as that key, that can't happen when keys only go up.
+*/
+template <typename T>
+class BucketQueue
+{
+public:
+    BucketQueue() : head(64, -1), mask(63) {}
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    void clear()
+    {
+        // anything left hangs off the buckets from base on
+        for (size_t k = 0; count > 0; ++k)
+        {
+            int &h = head[((size_t)base + k) & mask];
+            for (; h >= 0; h = next[h])
+                count--;
+        }
+        items.clear();
+        next.clear();
+        started = false;
+    }
+
+    void push(int key, const T &item)
+    {
+        if (!started)
+        {
+            base = key;
+            started = true;
+        }
+        if (key < base)
+            key = base;
+        if ((size_t)(key - base) > mask)
+            grow((size_t)(key - base) + 1);
+        int &h = head[(size_t)key & mask];
+        items.push_back(item);
+        next.push_back(h);
+        h = (int)items.size() - 1;
+        count++;
+    }
+
+    // smallest key, call only when not empty
+    T pop(int &keyOut)
+    {
+        while (head[(size_t)base & mask] < 0)
+            base++;
+        int &h = head[(size_t)base & mask];
+        int i = h;
+        h = next[i];
+        count--;
+        keyOut = base;
+        return items[i];
+    }
+
+    size_t memoryBytes() const
+    {
+        return head.capacity() * sizeof(int) + items.capacity() * sizeof(T) + next.capacity() * sizeof(int);
+    }
+
+private:
+    std::vector<int> head; // first item of the bucket for key k is head[k & mask], -1 = empty
+    std::vector<T> items;  // pool, only grows during a search
+    std::vector<int> next;
+    size_t mask;
+    int base = 0; // no queued key is below this
+    size_t count = 0;
+    bool started = false;
+
+    void grow(size_t span)
+    {
+        size_t n = head.size();
+        while (n < span)
+            n *= 2;
+        // same keys, new slots
+        std::vector<int> bigger(n, -1);
+        for (size_t k = 0; k < head.size(); ++k)
+            bigger[((size_t)base + k) & (n - 1)] = head[((size_t)base + k) & mask];
+        head.swap(bigger);
+        mask = n - 1;
+    }
+};
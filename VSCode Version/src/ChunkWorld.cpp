@@ -0,0 +1,361 @@
+#include "ChunkWorld.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+ChunkWorld::ChunkWorld(unsigned seed, int fillPercent, int smoothSteps)
+    : seed(seed), fillPercent(std::clamp(fillPercent, 1, 99)), smoothSteps(std::clamp(smoothSteps, 1, 8))
+{
+}
+
+ChunkWorld::~ChunkWorld()
+{
+    deletePages();
+}
+
+void ChunkWorld::setPageDirectory(const std::string &dir)
+{
+    if (dir == pageDir)
+        return;
+    // pages in the old directory can't be found any more, those edits are lost either way
+    deletePages();
+    pageDir = dir;
+}
+
+void ChunkWorld::deletePages()
+{
+    for (uint64_t key : pagedOut)
+        std::remove(pagePath((int)(uint32_t)(key >> 32), (int)(uint32_t)key).c_str());
+    pagedOut.clear();
+}
+
+void ChunkWorld::setStreamRadius(int load, int keep)
+{
+    loadRadius = std::max(load, 0);
+    keepRadius = std::max(keep, loadRadius);
+}
+
+// Generation
+
+bool ChunkWorld::initialWall(int tx, int ty) const
+{
+    // splitmix style hash of (seed, x, y), same answer no matter which chunk asks
+    uint64_t h = ((uint64_t)(uint32_t)tx << 32) ^ (uint32_t)ty ^ ((uint64_t)seed * 0x9E3779B97F4A7C15ull);
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return (int)(h % 100) < fillPercent;
+}
+
+void ChunkWorld::generateChunk(int cx, int cy, Chunk &out) const
+{
+    // fill the chunk plus a margin, every smoothing step the outermost ring goes stale by one
+    // tile, so after smoothSteps passes the inner CHUNK_SIZE square is exact
+    const int M = smoothSteps;
+    const int S = CHUNK_SIZE + 2 * M;
+    const int x0 = cx * CHUNK_SIZE - M, y0 = cy * CHUNK_SIZE - M;
+
+    std::vector<uint8_t> cur((size_t)S * S), next((size_t)S * S);
+    for (int y = 0; y < S; ++y)
+        for (int x = 0; x < S; ++x)
+            cur[(size_t)y * S + x] = initialWall(x0 + x, y0 + y) ? 1 : 0;
+
+    // same rule as Tilemap::generateCave
+    for (int step = 0; step < M; ++step)
+    {
+        next = cur;
+        for (int y = 1; y < S - 1; ++y)
+        {
+            for (int x = 1; x < S - 1; ++x)
+            {
+                const uint8_t *up = &cur[(size_t)(y - 1) * S + x];
+                const uint8_t *mid = &cur[(size_t)y * S + x];
+                const uint8_t *down = &cur[(size_t)(y + 1) * S + x];
+                int n = up[-1] + up[0] + up[1] + mid[-1] + mid[1] + down[-1] + down[0] + down[1];
+                if (n > 4)
+                    next[(size_t)y * S + x] = 1;
+                else if (n < 4)
+                    next[(size_t)y * S + x] = 0;
+            }
+        }
+        cur.swap(next);
+    }
+
+    out.tiles.resize((size_t)CHUNK_SIZE * CHUNK_SIZE);
+    for (int y = 0; y < CHUNK_SIZE; ++y)
+        std::copy_n(&cur[(size_t)(y + M) * S + M], CHUNK_SIZE, &out.tiles[(size_t)y * CHUNK_SIZE]);
+    out.dirty = false;
+}
+
+// Streaming
+
+std::string ChunkWorld::pagePath(int cx, int cy) const
+{
+    return pageDir + "/chunk_" + std::to_string(seed) + "_" + std::to_string(cx) + "_" + std::to_string(cy) + ".bin";
+}
+
+void ChunkWorld::loadChunk(int cx, int cy)
+{
+    uint64_t key = chunkKey(cx, cy);
+    Chunk &c = chunks[key];
+
+    // edited chunks come back from disk
+    if (pagedOut.count(key))
+    {
+        const std::string path = pagePath(cx, cy);
+        std::ifstream in(path, std::ios::binary);
+        c.tiles.resize((size_t)CHUNK_SIZE * CHUNK_SIZE);
+        bool ok = (bool)in.read((char *)c.tiles.data(), (std::streamsize)c.tiles.size());
+        in.close();
+        // the chunk is in memory now, it gets written again if it's evicted
+        std::remove(path.c_str());
+        pagedOut.erase(key);
+        if (ok)
+        {
+            c.dirty = true; // stays an edited chunk
+            return;
+        }
+        // file went missing or was cut short, regenerate
+    }
+    generateChunk(cx, cy, c);
+}
+
+void ChunkWorld::evictChunk(uint64_t key, Chunk &c)
+{
+    if (!c.dirty || pageDir.empty())
+        return;
+    int cx = (int)(uint32_t)(key >> 32), cy = (int)(uint32_t)key;
+    std::ofstream out(pagePath(cx, cy), std::ios::binary | std::ios::trunc);
+    if (out.write((const char *)c.tiles.data(), (std::streamsize)c.tiles.size()))
+        pagedOut.insert(key);
+}
+
+void ChunkWorld::update(Vector2 playerWorld)
+{
+    int ptx, pty;
+    worldToTile(playerWorld, ptx, pty);
+    int pcx = floorDiv(ptx, CHUNK_SIZE), pcy = floorDiv(pty, CHUNK_SIZE);
+
+    // evict anything outside the keep radius
+    for (auto it = chunks.begin(); it != chunks.end();)
+    {
+        int cx = (int)(uint32_t)(it->first >> 32), cy = (int)(uint32_t)it->first;
+        if (std::max(abs(cx - pcx), abs(cy - pcy)) > keepRadius)
+        {
+            evictChunk(it->first, it->second);
+            it = chunks.erase(it);
+        }
+        else
+            ++it;
+    }
+    cachedKey = ~0ull;
+    cachedChunk = nullptr;
+
+    // load what's near
+    for (int cy = pcy - loadRadius; cy <= pcy + loadRadius; ++cy)
+        for (int cx = pcx - loadRadius; cx <= pcx + loadRadius; ++cx)
+            if (!isLoaded(cx, cy))
+                loadChunk(cx, cy);
+}
+
+size_t ChunkWorld::memoryBytes() const
+{
+    size_t bytes = sizeof(*this);
+    for (auto &kv : chunks)
+        bytes += sizeof(kv) + kv.second.tiles.capacity();
+    return bytes + pagedOut.size() * sizeof(uint64_t);
+}
+
+// Queries
+
+const ChunkWorld::Chunk *ChunkWorld::findChunk(int cx, int cy) const
+{
+    uint64_t key = chunkKey(cx, cy);
+    if (key == cachedKey)
+        return cachedChunk;
+    auto it = chunks.find(key);
+    cachedKey = key;
+    cachedChunk = (it == chunks.end()) ? nullptr : &it->second;
+    return cachedChunk;
+}
+
+bool ChunkWorld::isWall(int tx, int ty) const
+{
+    int cx = floorDiv(tx, CHUNK_SIZE), cy = floorDiv(ty, CHUNK_SIZE);
+    const Chunk *c = findChunk(cx, cy);
+    if (!c)
+        return true; // not loaded, treat as rock
+    int lx = tx - cx * CHUNK_SIZE, ly = ty - cy * CHUNK_SIZE;
+    return c->tiles[(size_t)ly * CHUNK_SIZE + lx] != 0;
+}
+
+void ChunkWorld::carveCircle(Vector2 centerWorld, float radiusPx)
+{
+    int minTx = (int)floorf((centerWorld.x - radiusPx) / TILE_SIZE);
+    int minTy = (int)floorf((centerWorld.y - radiusPx) / TILE_SIZE);
+    int maxTx = (int)floorf((centerWorld.x + radiusPx) / TILE_SIZE);
+    int maxTy = (int)floorf((centerWorld.y + radiusPx) / TILE_SIZE);
+
+    for (int ty = minTy; ty <= maxTy; ++ty)
+    {
+        for (int tx = minTx; tx <= maxTx; ++tx)
+        {
+            Rectangle t = {tx * (float)TILE_SIZE, ty * (float)TILE_SIZE, (float)TILE_SIZE, (float)TILE_SIZE};
+            if (!CheckCollisionCircleRec(centerWorld, radiusPx, t))
+                continue;
+            int cx = floorDiv(tx, CHUNK_SIZE), cy = floorDiv(ty, CHUNK_SIZE);
+            auto it = chunks.find(chunkKey(cx, cy));
+            if (it == chunks.end())
+                continue; // can't edit what isn't loaded
+            uint8_t &tile = it->second.tiles[(size_t)(ty - cy * CHUNK_SIZE) * CHUNK_SIZE + (tx - cx * CHUNK_SIZE)];
+            if (tile)
+            {
+                tile = 0;
+                it->second.dirty = true;
+            }
+        }
+    }
+}
+
+void ChunkWorld::draw(Rectangle view) const
+{
+    int minX = (int)floorf(view.x / TILE_SIZE), minY = (int)floorf(view.y / TILE_SIZE);
+    int maxX = (int)floorf((view.x + view.width) / TILE_SIZE), maxY = (int)floorf((view.y + view.height) / TILE_SIZE);
+    for (int y = minY; y <= maxY; ++y)
+    {
+        for (int x = minX; x <= maxX; ++x)
+        {
+            Color c = isWall(x, y) ? Color{30, 45, 55, 255} : Color{18, 120, 100, 255};
+            DrawRectangle(x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE, c);
+        }
+    }
+}
+
+bool ChunkWorld::hasLineOfSight(Vector2 a, Vector2 b) const
+{
+    // same bresenham walk as Tilemap, crosses chunk borders through isWall
+    int x0, y0, x1, y1;
+    worldToTile(a, x0, y0);
+    worldToTile(b, x1, y1);
+    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    while (true)
+    {
+        if (isWall(x0, y0))
+            return false;
+        if (x0 == x1 && y0 == y1)
+            break;
+        int e2 = 2 * err;
+        if (e2 >= dy)
+        {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx)
+        {
+            err += dx;
+            y0 += sy;
+        }
+    }
+    return true;
+}
+
+bool ChunkWorld::findPath(Vector2 startWorld, Vector2 goalWorld, std::vector<Vector2> &outPath, int maxExpansions) const
+{
+    // same A* rules as Tilemap::findPath (8 way, 10/14, no corner cutting)
+    // but the search state is a hash map since the world has no fixed size
+    int sx, sy, gx, gy;
+    worldToTile(startWorld, sx, sy);
+    worldToTile(goalWorld, gx, gy);
+    if (isWall(gx, gy))
+        return false;
+
+    struct Rec
+    {
+        int g;
+        uint8_t dir;
+        bool closed;
+    };
+    std::unordered_map<uint64_t, Rec> state;
+    state.reserve(std::min(maxExpansions, 4096) * 2);
+    auto key = [](int x, int y)
+    { return chunkKey(x, y); };
+
+    auto Hcost = [&](int x, int y)
+    {
+        // octile, admissible with diagonal steps costing 14
+        int dx = abs(x - gx), dy = abs(y - gy);
+        return 10 * std::max(dx, dy) + 4 * std::min(dx, dy);
+    };
+
+    struct Q
+    {
+        int x, y, f;
+    };
+    auto cmp = [](const Q &a, const Q &b)
+    { return a.f > b.f; };
+    std::vector<Q> heap;
+
+    const int DIR8[8][2] = {
+        {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1}};
+
+    state[key(sx, sy)] = {0, 0, false};
+    heap.push_back({sx, sy, Hcost(sx, sy)});
+
+    int expanded = 0;
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        Q cur = heap.back();
+        heap.pop_back();
+        Rec &cr = state[key(cur.x, cur.y)];
+        if (cr.closed)
+            continue;
+        cr.closed = true;
+        int x = cur.x, y = cur.y;
+
+        if (x == gx && y == gy)
+        {
+            outPath.clear();
+            while (!(x == sx && y == sy))
+            {
+                outPath.push_back(tileToWorldCenter(x, y));
+                int d = state[key(x, y)].dir;
+                x -= DIR8[d][0];
+                y -= DIR8[d][1];
+            }
+            std::reverse(outPath.begin(), outPath.end());
+            return true;
+        }
+        if (++expanded > maxExpansions)
+            return false;
+
+        int cg = cr.g;
+        for (int i = 0; i < 8; ++i)
+        {
+            int nx = x + DIR8[i][0], ny = y + DIR8[i][1];
+            if (isWall(nx, ny))
+                continue;
+            bool diagonal = (DIR8[i][0] != 0 && DIR8[i][1] != 0);
+            if (diagonal && (isWall(x + DIR8[i][0], y) || isWall(x, y + DIR8[i][1])))
+                continue;
+
+            int g = cg + (diagonal ? 14 : 10);
+            auto ins = state.try_emplace(key(nx, ny), Rec{g, (uint8_t)i, false});
+            if (!ins.second)
+            {
+                Rec &r = ins.first->second;
+                if (r.closed || g >= r.g)
+                    continue;
+                r.g = g;
+                r.dir = (uint8_t)i;
+            }
+            heap.push_back({nx, ny, g + Hcost(nx, ny)});
+            std::push_heap(heap.begin(), heap.end(), cmp);
+        }
+    }
+    return false;
+}
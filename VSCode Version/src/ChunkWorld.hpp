@@ -0,0 +1,99 @@
+#pragma once
+#include <raylib.h>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Tilemap.hpp"
+
+/*
+Streaming cave world made of fixed size chunks.
+Chunks are generated on demand from the seed as the player gets near and dropped again once
+the player is far away, so memory stays flat however far you travel. The world has no edge,
+tile coordinates can go negative.
+
+Every chunk is the exact result of running the cellular automaton on an infinite grid:
+the random fill is a pure hash of (seed, x, y) and each chunk is smoothed with a margin of
+smoothSteps tiles around it, so chunks line up seamlessly across borders.
+
+Chunks that were carved are written to the page directory when evicted and read back when
+the player returns (without a page directory the edits are dropped and the chunk regenerates).
+Page files only live as long as the world: a file is deleted once its chunk is loaded back, and
+whatever is still paged out is deleted when the world is destroyed or the directory changes.
+
+Queries treat tiles in chunks that are not loaded as walls. Not thread safe.
+*/
+class ChunkWorld
+{
+public:
+    static const int CHUNK_SIZE = 64;
+    static const int TILE_SIZE = Tilemap::TILE_SIZE;
+
+    ChunkWorld(unsigned seed = 1337, int fillPercent = 45, int smoothSteps = 5);
+    ~ChunkWorld();
+    // owns its page files, a copy would delete them out from under the other one
+    ChunkWorld(const ChunkWorld &) = delete;
+    ChunkWorld &operator=(const ChunkWorld &) = delete;
+
+    // streaming, radii are in chunks (chebyshev) around the player's chunk
+    void setStreamRadius(int loadRadius, int keepRadius);
+    void setPageDirectory(const std::string &dir);
+    void update(Vector2 playerWorld); // load near chunks, evict far ones
+
+    bool isWall(int tx, int ty) const;
+    bool isLoaded(int cx, int cy) const { return chunks.count(chunkKey(cx, cy)) != 0; }
+
+    bool hasLineOfSight(Vector2 a, Vector2 b) const;
+    // A* limited to maxExpansions nodes, the world has no edge to stop it
+    bool findPath(Vector2 startWorld, Vector2 goalWorld, std::vector<Vector2> &outPath, int maxExpansions = 20000) const;
+    void carveCircle(Vector2 centerWorld, float radiusPx);
+    void draw(Rectangle view) const;
+
+    int loadedChunkCount() const { return (int)chunks.size(); }
+    size_t memoryBytes() const;
+
+    // tile helper functions, floor so negative coordinates land in the right tile
+    inline Vector2 tileToWorldCenter(int tx, int ty) const
+    {
+        return {tx * (float)TILE_SIZE + TILE_SIZE * 0.5f, ty * (float)TILE_SIZE + TILE_SIZE * 0.5f};
+    }
+    inline void worldToTile(Vector2 p, int &tx, int &ty) const
+    {
+        tx = (int)floorf(p.x / TILE_SIZE);
+        ty = (int)floorf(p.y / TILE_SIZE);
+    }
+
+private:
+    struct Chunk
+    {
+        std::vector<uint8_t> tiles; // CHUNK_SIZE*CHUNK_SIZE, 1 = wall
+        bool dirty = false;         // carved since it was generated
+    };
+
+    unsigned seed;
+    int fillPercent;
+    int smoothSteps;
+    int loadRadius = 2;
+    int keepRadius = 3;
+    std::string pageDir;
+
+    std::unordered_map<uint64_t, Chunk> chunks;
+    std::unordered_set<uint64_t> pagedOut; // chunks with edits sitting in pageDir
+
+    // isWall is called a lot with nearby tiles, remember the last chunk hit
+    mutable uint64_t cachedKey = ~0ull;
+    mutable const Chunk *cachedChunk = nullptr;
+
+    static uint64_t chunkKey(int cx, int cy) { return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy; }
+    static int floorDiv(int a, int b) { return (a >= 0) ? a / b : -((-a + b - 1) / b); }
+
+    bool initialWall(int tx, int ty) const; // random fill before smoothing
+    void generateChunk(int cx, int cy, Chunk &out) const;
+    std::string pagePath(int cx, int cy) const;
+    void loadChunk(int cx, int cy);
+    void evictChunk(uint64_t key, Chunk &c);
+    void deletePages(); // remove every paged out chunk's file
+    const Chunk *findChunk(int cx, int cy) const;
+};
@@ -0,0 +1,47 @@
+#include "CircleStamp.hpp"
+#include <raylib.h>
+#include <cmath>
+
+void CircleStampCache::snap(float world, int tileSize, int &tile, int &sub)
+{
+    int q = (int)floorf(world * SUBTILE / tileSize + 0.5f);
+    tile = (q >= 0) ? q / SUBTILE : -((-q + SUBTILE - 1) / SUBTILE);
+    sub = q - tile * SUBTILE;
+}
+
+const CircleSpans &CircleStampCache::get(float radiusPx, int tileSize, int subX, int subY)
+{
+    int halfPx = (int)(radiusPx * 2.0f + 0.5f);
+    uint32_t key = ((uint32_t)halfPx << 8) | ((uint32_t)subY << 4) | (uint32_t)subX;
+    auto it = cache.find(key);
+    if (it != cache.end())
+        return it->second;
+
+    // centre relative to the top left of its tile
+    const float r = halfPx * 0.5f;
+    const float T = (float)tileSize;
+    Vector2 c = {subX * T / SUBTILE, subY * T / SUBTILE};
+
+    // same bounding box carveCircle scanned, then the exact test on every tile in it
+    int minX = (int)floorf((c.x - r) / T), maxX = (int)floorf((c.x + r) / T);
+    int minY = (int)floorf((c.y - r) / T), maxY = (int)floorf((c.y + r) / T);
+
+    CircleSpans &s = cache[key];
+    s.rowMin = minY;
+    for (int y = minY; y <= maxY; ++y)
+    {
+        int16_t first = 1, last = 0; // empty unless something hits
+        for (int x = minX; x <= maxX; ++x)
+        {
+            Rectangle t = {x * T, y * T, T, T};
+            if (!CheckCollisionCircleRec(c, r, t))
+                continue;
+            if (first > last)
+                first = (int16_t)x;
+            last = (int16_t)x;
+        }
+        s.x0.push_back(first);
+        s.x1.push_back(last);
+    }
+    return s;
+}
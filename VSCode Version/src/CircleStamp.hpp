@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// tiles a circle touches, one run of tiles per row.
+// row r is tile row (centre tile y + rowMin + r) and covers x offsets x0[r]..x1[r] from the centre tile
+struct CircleSpans
+{
+    int rowMin = 0;
+    std::vector<int16_t> x0, x1;
+    int rows() const { return (int)x0.size(); }
+};
+
+/*
+Cache of circle footprints for carving.
+Centres are snapped to 1/SUBTILE of a tile, so for a given radius there are only
+SUBTILE*SUBTILE different footprints. Each one is worked out once with the same
+CheckCollisionCircleRec test carveCircle always used, then reused as integer spans.
+Radii are keyed to half a pixel.
+*/
+class CircleStampCache
+{
+public:
+    static const int SUBTILE = 8;
+
+    // snap a world coordinate to the grid, gives the tile and the offset inside it (0..SUBTILE-1)
+    static void snap(float world, int tileSize, int &tile, int &sub);
+
+    const CircleSpans &get(float radiusPx, int tileSize, int subX, int subY);
+    size_t size() const { return cache.size(); }
+
+private:
+    std::unordered_map<uint32_t, CircleSpans> cache;
+};
@@ -0,0 +1,99 @@
+#include "ClearanceField.hpp"
+#include <algorithm>
+#include <cmath>
+
+ClearanceField::ClearanceField()
+{
+    // walls sit at whole tile offsets (dx,dy) with chamfer 3*max+min >= d. the gap between two
+    // tile squares at that offset is the euclidean length of (|dx|-1, |dy|-1) clamped at 0.
+    // take the smallest gap over every offset that is still allowed
+    for (int d = 0; d <= CAP; ++d)
+    {
+        float best = 1e9f;
+        for (int a = 0; a <= CAP_TILES + 1; ++a)
+        {
+            for (int b = 0; b <= a; ++b)
+            {
+                if (3 * a + b < d)
+                    continue;
+                float gx = (float)std::max(a - 1, 0), gy = (float)std::max(b - 1, 0);
+                best = std::min(best, sqrtf(gx * gx + gy * gy));
+            }
+        }
+        minGap[d] = best;
+    }
+}
+
+void ClearanceField::build(const uint8_t *cells, int w, int h)
+{
+    width = w;
+    height = h;
+    dist.assign((size_t)w * h, 0);
+    if (w > 0 && h > 0)
+        sweep(cells, 0, 0, w - 1, h - 1);
+}
+
+void ClearanceField::update(const uint8_t *cells, int minX, int minY, int maxX, int maxY)
+{
+    // anything further than CAP from the change already was (and stays) at CAP
+    minX = std::max(0, minX - CAP_TILES - 1);
+    minY = std::max(0, minY - CAP_TILES - 1);
+    maxX = std::min(width - 1, maxX + CAP_TILES + 1);
+    maxY = std::min(height - 1, maxY + CAP_TILES + 1);
+    if (minX > maxX || minY > maxY)
+        return;
+    sweep(cells, minX, minY, maxX, maxY);
+}
+
+void ClearanceField::sweep(const uint8_t *cells, int minX, int minY, int maxX, int maxY)
+{
+    // seed the window, tiles outside it keep their values and act as the boundary
+    for (int y = minY; y <= maxY; ++y)
+    {
+        for (int x = minX; x <= maxX; ++x)
+        {
+            size_t i = (size_t)y * width + x;
+            dist[i] = cells[i] ? 0 : CAP;
+        }
+    }
+
+    // neighbour value, outside the map is wall
+    auto get = [&](int x, int y) -> int
+    {
+        return ((unsigned)x < (unsigned)width && (unsigned)y < (unsigned)height) ? dist[(size_t)y * width + x] : 0;
+    };
+
+    // forward pass, neighbours above and to the left
+    for (int y = minY; y <= maxY; ++y)
+    {
+        uint8_t *row = &dist[(size_t)y * width];
+        for (int x = minX; x <= maxX; ++x)
+        {
+            int d = row[x];
+            if (d == 0)
+                continue;
+            d = std::min(d, get(x - 1, y) + 3);
+            d = std::min(d, get(x - 1, y - 1) + 4);
+            d = std::min(d, get(x, y - 1) + 3);
+            d = std::min(d, get(x + 1, y - 1) + 4);
+            row[x] = (uint8_t)d;
+        }
+    }
+
+    // backward pass, neighbours below and to the right
+    for (int y = maxY; y >= minY; --y)
+    {
+        uint8_t *row = &dist[(size_t)y * width];
+        for (int x = maxX; x >= minX; --x)
+        {
+            int d = row[x];
+            if (d == 0)
+                continue;
+            d = std::min(d, get(x + 1, y) + 3);
+            d = std::min(d, get(x + 1, y + 1) + 4);
+            d = std::min(d, get(x, y + 1) + 3);
+            d = std::min(d, get(x - 1, y + 1) + 4);
+            row[x] = (uint8_t)d;
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/*
+Distance from every tile to the nearest wall tile, as a 3-4 chamfer transform
+(3 per straight step, 4 per diagonal, so value/3 is roughly the distance in tiles).
+Walls are 0, anything outside the map counts as wall, values stop at CAP.
+
+Carving only ever turns walls into floor, so after a carve only tiles within CAP of
+the changed box can change. update() redoes the two passes over just that window,
+reading the tiles around it as they are.
+*/
+class ClearanceField
+{
+public:
+    static const int CAP_TILES = 8;
+    static const int CAP = CAP_TILES * 3;
+
+    ClearanceField();
+
+    // cells: one byte per tile, nonzero = wall
+    void build(const uint8_t *cells, int width, int height);
+    // tiles inside [minX,maxX]x[minY,maxY] changed in cells
+    void update(const uint8_t *cells, int minX, int minY, int maxX, int maxY);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    size_t memoryBytes() const { return dist.capacity(); }
+
+    inline int at(int x, int y) const
+    {
+        if ((unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height)
+            return 0;
+        return dist[(size_t)y * width + x];
+    }
+
+    // lower bound, in tiles, on the distance from any point inside tile (x,y) to any wall tile
+    inline float clearanceTiles(int x, int y) const { return minGap[at(x, y)]; }
+
+private:
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> dist;
+    float minGap[CAP + 1]; // chamfer value -> closest a wall square can be to the tile
+
+    void sweep(const uint8_t *cells, int minX, int minY, int maxX, int maxY);
+};
@@ -0,0 +1,511 @@
+#include "ClusterGraph.hpp"
+#include "Tilemap.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <functional>
+
+// same step order as Pathfinder, the first four are straight
+static const int DIR8[8][2] = {
+    {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1}};
+
+static int octile(int x0, int y0, int x1, int y1)
+{
+    int dx = abs(x1 - x0), dy = abs(y1 - y0);
+    return 10 * std::max(dx, dy) + 4 * std::min(dx, dy);
+}
+
+size_t ClusterGraph::memoryBytes() const
+{
+    size_t bytes = nodes.capacity() * sizeof(Node) + freeNodes.capacity() * sizeof(int) +
+                   clusterNodes.capacity() * sizeof(std::vector<int>);
+    for (const Node &n : nodes)
+        bytes += n.edges.capacity() * sizeof(Edge);
+    for (const auto &list : clusterNodes)
+        bytes += list.capacity() * sizeof(int);
+    return bytes;
+}
+
+void ClusterGraph::clusterRect(int c, int &x0, int &y0, int &x1, int &y1) const
+{
+    x0 = (c % clusterW) * CLUSTER;
+    y0 = (c / clusterW) * CLUSTER;
+    x1 = std::min(width, x0 + CLUSTER) - 1;
+    y1 = std::min(height, y0 + CLUSTER) - 1;
+}
+
+int ClusterGraph::addNode(int x, int y, Side side)
+{
+    int id;
+    if (!freeNodes.empty())
+    {
+        id = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    else
+    {
+        id = (int)nodes.size();
+        nodes.emplace_back();
+    }
+    Node &n = nodes[id];
+    n.x = x;
+    n.y = y;
+    n.cluster = clusterOf(x, y);
+    n.peer = -1;
+    n.side = side;
+    n.edges.clear();
+    clusterNodes[n.cluster].push_back(id);
+    liveNodes++;
+    return id;
+}
+
+void ClusterGraph::removeNode(int id)
+{
+    // the slot is reused, clusters and peers drop their references first
+    nodes[id].cluster = -1;
+    nodes[id].peer = -1;
+    nodes[id].edges.clear();
+    freeNodes.push_back(id);
+    liveNodes--;
+}
+
+void ClusterGraph::removeSide(int cluster, Side side)
+{
+    std::vector<int> &list = clusterNodes[cluster];
+    size_t keep = 0;
+    for (int id : list)
+    {
+        if (nodes[id].side == side)
+            removeNode(id);
+        else
+            list[keep++] = id;
+    }
+    list.resize(keep);
+}
+
+void ClusterGraph::scanBorder(const uint8_t *cells, int cluster, Side side)
+{
+    int x0, y0, x1, y1;
+    clusterRect(cluster, x0, y0, x1, y1);
+
+    // walk along the border, (ax,ay) on this side and the tile across from it
+    const bool right = (side == RIGHT);
+    const int len = right ? (y1 - y0 + 1) : (x1 - x0 + 1);
+    auto across = [&](int i, int &ax, int &ay, int &bx, int &by)
+    {
+        ax = right ? x1 : x0 + i;
+        ay = right ? y0 + i : y1;
+        bx = right ? ax + 1 : ax;
+        by = right ? ay : ay + 1;
+    };
+    auto link = [&](int i)
+    {
+        int ax, ay, bx, by;
+        across(i, ax, ay, bx, by);
+        int a = addNode(ax, ay, side);
+        int b = addNode(bx, by, right ? LEFT : TOP);
+        nodes[a].peer = b;
+        nodes[b].peer = a;
+    };
+
+    int runStart = -1;
+    for (int i = 0; i <= len; ++i)
+    {
+        bool open = false;
+        if (i < len)
+        {
+            int ax, ay, bx, by;
+            across(i, ax, ay, bx, by);
+            open = !cells[(size_t)ay * width + ax] && !cells[(size_t)by * width + bx];
+        }
+        if (open && runStart < 0)
+            runStart = i;
+        else if (!open && runStart >= 0)
+        {
+            // narrow openings get one node in the middle, wide ones one at each end
+            int runEnd = i - 1;
+            if (runEnd - runStart + 1 < LONG_ENTRANCE)
+                link((runStart + runEnd) / 2);
+            else
+            {
+                link(runStart);
+                link(runEnd);
+            }
+            runStart = -1;
+        }
+    }
+}
+
+void ClusterGraph::loadCluster(const uint8_t *cells, int c, Search &s) const
+{
+    int x0, y0, x1, y1;
+    clusterRect(c, x0, y0, x1, y1);
+    s.grid.assign(PAD * PAD, 1);
+    for (int y = y0; y <= y1; ++y)
+        for (int x = x0; x <= x1; ++x)
+            s.grid[padIndex(x, y)] = cells[(size_t)y * width + x] ? 1 : 0;
+}
+
+int ClusterGraph::localSearch(int start, Search &s)
+{
+    s.cost.assign(PAD * PAD, -1);
+    s.from.resize(PAD * PAD);
+    for (auto &b : s.buckets)
+        b.clear();
+    int targetsLeft = (int)s.targets.size();
+
+    // costs are all even and a step adds 5 or 7 halves, so eight buckets going round in
+    // order of cost work as the open list with no sorting at all
+    s.cost[start] = 0;
+    s.buckets[0].push_back((uint16_t)start);
+    int pending = 1, settled = 0;
+    for (int half = 0; pending > 0; ++half)
+    {
+        std::vector<uint16_t> &bucket = s.buckets[half & 7];
+        for (size_t b = 0; b < bucket.size(); ++b)
+        {
+            int i = bucket[b], d = half * 2;
+            pending--;
+            if (d > s.cost[i])
+                continue;
+            settled++;
+            if (targetsLeft > 0 && std::find(s.targets.begin(), s.targets.end(), i) != s.targets.end())
+            {
+                // the same cell can be listed twice (two nodes on one corner tile)
+                targetsLeft -= (int)std::count(s.targets.begin(), s.targets.end(), i);
+                if (targetsLeft <= 0)
+                    return settled;
+            }
+
+            // the wall ring round the grid means no bounds checks
+            for (int k = 0; k < 8; ++k)
+            {
+                int sx = DIR8[k][0], sy = DIR8[k][1] * PAD;
+                int ni = i + sx + sy;
+                if (s.grid[ni])
+                    continue;
+                // no corner cutting
+                if (k >= 4 && (s.grid[i + sx] || s.grid[i + sy]))
+                    continue;
+                int nd = d + (k >= 4 ? 14 : 10);
+                if (s.cost[ni] < 0 || nd < s.cost[ni])
+                {
+                    s.cost[ni] = nd;
+                    s.from[ni] = (uint8_t)k;
+                    s.buckets[(nd / 2) & 7].push_back((uint16_t)ni);
+                    pending++;
+                }
+            }
+        }
+        bucket.clear();
+    }
+    return settled;
+}
+
+void ClusterGraph::linkCluster(const uint8_t *cells, int cluster)
+{
+    const std::vector<int> &list = clusterNodes[cluster];
+    if (list.empty())
+        return;
+    Search &s = linkScratch;
+    loadCluster(cells, cluster, s);
+    for (int a : list)
+        nodes[a].edges.clear();
+
+    // walking costs are the same both ways, so each search only has to reach the nodes after it
+    for (size_t i = 0; i + 1 < list.size(); ++i)
+    {
+        int a = list[i];
+        s.targets.clear();
+        for (size_t j = i + 1; j < list.size(); ++j)
+            s.targets.push_back(padIndex(nodes[list[j]].x, nodes[list[j]].y));
+        localSearch(padIndex(nodes[a].x, nodes[a].y), s);
+        for (size_t j = i + 1; j < list.size(); ++j)
+        {
+            int b = list[j];
+            int d = s.cost[padIndex(nodes[b].x, nodes[b].y)];
+            if (d < 0)
+                continue;
+            nodes[a].edges.push_back({b, d});
+            nodes[b].edges.push_back({a, d});
+        }
+    }
+}
+
+void ClusterGraph::build(const uint8_t *cells, int w, int h)
+{
+    width = w;
+    height = h;
+    clusterW = (w + CLUSTER - 1) / CLUSTER;
+    clusterH = (h + CLUSTER - 1) / CLUSTER;
+    nodes.clear();
+    freeNodes.clear();
+    clusterNodes.assign((size_t)clusterW * clusterH, {});
+    liveNodes = 0;
+
+    for (int cy = 0; cy < clusterH; ++cy)
+    {
+        for (int cx = 0; cx < clusterW; ++cx)
+        {
+            int c = cy * clusterW + cx;
+            if (cx + 1 < clusterW)
+                scanBorder(cells, c, RIGHT);
+            if (cy + 1 < clusterH)
+                scanBorder(cells, c, BOTTOM);
+        }
+    }
+    for (int c = 0; c < clusterW * clusterH; ++c)
+        linkCluster(cells, c);
+}
+
+void ClusterGraph::update(const uint8_t *cells, int minX, int minY, int maxX, int maxY)
+{
+    minX = std::max(0, minX);
+    minY = std::max(0, minY);
+    maxX = std::min(width - 1, maxX);
+    maxY = std::min(height - 1, maxY);
+    if (!ready() || minX > maxX || minY > maxY)
+        return;
+
+    // borders the box reaches, stored as (cluster, RIGHT or BOTTOM) so each is redone once
+    std::vector<std::pair<int, int>> borders;
+    std::vector<int> relink;
+    for (int cy = minY / CLUSTER; cy <= maxY / CLUSTER; ++cy)
+    {
+        for (int cx = minX / CLUSTER; cx <= maxX / CLUSTER; ++cx)
+        {
+            int c = cy * clusterW + cx;
+            int x0, y0, x1, y1;
+            clusterRect(c, x0, y0, x1, y1);
+            relink.push_back(c);
+            if (maxX >= x1 && cx + 1 < clusterW)
+                borders.push_back({c, RIGHT});
+            if (minX <= x0 && cx > 0)
+                borders.push_back({c - 1, RIGHT});
+            if (maxY >= y1 && cy + 1 < clusterH)
+                borders.push_back({c, BOTTOM});
+            if (minY <= y0 && cy > 0)
+                borders.push_back({c - clusterW, BOTTOM});
+        }
+    }
+    std::sort(borders.begin(), borders.end());
+    borders.erase(std::unique(borders.begin(), borders.end()), borders.end());
+
+    for (auto [c, side] : borders)
+    {
+        int other = (side == RIGHT) ? c + 1 : c + clusterW;
+        removeSide(c, (Side)side);
+        removeSide(other, side == RIGHT ? LEFT : TOP);
+        scanBorder(cells, c, (Side)side);
+        relink.push_back(c);
+        relink.push_back(other);
+    }
+
+    // every cluster that gained or lost nodes, or whose inside changed
+    std::sort(relink.begin(), relink.end());
+    relink.erase(std::unique(relink.begin(), relink.end()), relink.end());
+    for (int c : relink)
+        linkCluster(cells, c);
+}
+
+void ClusterGraph::appendLocalPath(const Tilemap &map, int c, int fx, int fy, int tx, int ty, Search &s,
+                                   std::vector<Vector2> &out, int &expanded) const
+{
+    if (fx == tx && fy == ty)
+        return;
+    const uint8_t *cells = map.data();
+
+    // most steps are a plain diagonal then straight (or straight then diagonal) walk. if one
+    // of those is clear it costs the octile distance, which nothing can beat
+    const size_t mark = out.size();
+    for (int diagonalFirst = 1; diagonalFirst >= 0; --diagonalFirst)
+    {
+        int x = fx, y = fy;
+        int ddx = (tx > fx) - (tx < fx), ddy = (ty > fy) - (ty < fy);
+        int diag = std::min(abs(tx - fx), abs(ty - fy));
+        bool clear = true;
+        while (clear && !(x == tx && y == ty))
+        {
+            bool diagonalStep = diagonalFirst ? diag > 0 : (abs(tx - x) == abs(ty - y));
+            int sx = ddx, sy = ddy;
+            if (!diagonalStep)
+            {
+                // straight part, along whichever axis still has distance left over
+                if (abs(tx - x) > abs(ty - y))
+                    sy = 0;
+                else
+                    sx = 0;
+            }
+            else
+                diag--;
+            if (cells[(size_t)(y + sy) * width + x + sx] || (sx && sy && (cells[(size_t)y * width + x + sx] || cells[(size_t)(y + sy) * width + x])))
+                clear = false;
+            else
+            {
+                x += sx;
+                y += sy;
+                out.push_back(map.tileToWorldCenter(x, y));
+            }
+        }
+        if (clear)
+            return;
+        out.resize(mark);
+    }
+
+    loadCluster(cells, c, s);
+    s.targets.assign(1, padIndex(tx, ty));
+    expanded += localSearch(padIndex(fx, fy), s);
+
+    // backtrack into route, then append in walking order
+    s.route.clear();
+    int x = tx, y = ty;
+    while (!(x == fx && y == fy))
+    {
+        s.route.push_back(y * width + x);
+        int k = s.from[padIndex(x, y)];
+        x -= DIR8[k][0];
+        y -= DIR8[k][1];
+    }
+    for (auto it = s.route.rbegin(); it != s.route.rend(); ++it)
+        out.push_back(map.tileToWorldCenter(*it % width, *it / width));
+}
+
+bool ClusterGraph::findPath(const Tilemap &map, int sx, int sy, int gx, int gy, std::vector<Vector2> &outPath,
+                            Search &s, int &expanded) const
+{
+    expanded = 0;
+    if (!ready() || map.getWidth() != width || map.getHeight() != height)
+        return false;
+    const uint8_t *cells = map.data();
+    const int cs = clusterOf(sx, sy), cg = clusterOf(gx, gy);
+
+    // per node scratch, same stamp trick as Pathfinder
+    if (s.visit.size() != nodes.size())
+    {
+        s.visit.assign(nodes.size(), 0);
+        s.g.resize(nodes.size());
+        s.parent.resize(nodes.size());
+        s.toGoal.assign(nodes.size(), -1);
+        s.stamp = 0;
+    }
+    if (s.stamp >= 0x7FFFFFFEu)
+    {
+        std::fill(s.visit.begin(), s.visit.end(), 0);
+        s.stamp = 0;
+    }
+    s.stamp++;
+    const uint32_t OPEN = s.stamp * 2, CLOSED = s.stamp * 2 + 1;
+
+    // walking costs from the start to the nodes of its cluster, and from the goal to its own
+    const std::vector<int> &startNodes = clusterNodes[cs], &goalNodes = clusterNodes[cg];
+    loadCluster(cells, cs, s);
+    s.targets.clear();
+    for (int id : startNodes)
+        s.targets.push_back(padIndex(nodes[id].x, nodes[id].y));
+    if (cs == cg)
+        s.targets.push_back(padIndex(gx, gy));
+    expanded += localSearch(padIndex(sx, sy), s);
+    int direct = (cs == cg) ? s.cost[padIndex(gx, gy)] : -1;
+    s.startCost.clear();
+    for (int id : startNodes)
+        s.startCost.push_back(s.cost[padIndex(nodes[id].x, nodes[id].y)]);
+
+    loadCluster(cells, cg, s);
+    s.targets.clear();
+    for (int id : goalNodes)
+        s.targets.push_back(padIndex(nodes[id].x, nodes[id].y));
+    expanded += localSearch(padIndex(gx, gy), s);
+    for (int id : goalNodes)
+        s.toGoal[id] = s.cost[padIndex(nodes[id].x, nodes[id].y)];
+
+    std::greater<std::pair<int, int>> cmp;
+    s.heap.clear();
+    auto push = [&](int f, int id)
+    { s.heap.push_back({f, id}); std::push_heap(s.heap.begin(), s.heap.end(), cmp); };
+
+    int bestGoal = INT_MAX, goalVia = -1; // goalVia -1 means straight from the start
+    if (direct >= 0)
+    {
+        bestGoal = direct;
+        push(direct, -1);
+    }
+    for (size_t k = 0; k < startNodes.size(); ++k)
+    {
+        int id = startNodes[k], d = s.startCost[k];
+        if (d < 0 || (s.visit[id] == OPEN && s.g[id] <= d))
+            continue;
+        s.visit[id] = OPEN;
+        s.g[id] = d;
+        s.parent[id] = -1;
+        push(d + octile(nodes[id].x, nodes[id].y, gx, gy), id);
+    }
+
+    bool found = false;
+    while (!s.heap.empty())
+    {
+        std::pop_heap(s.heap.begin(), s.heap.end(), cmp);
+        int id = s.heap.back().second;
+        s.heap.pop_back();
+        if (id < 0)
+        {
+            found = true;
+            break;
+        }
+        if (s.visit[id] == CLOSED)
+            continue;
+        s.visit[id] = CLOSED;
+        expanded++;
+        const Node &n = nodes[id];
+        int g = s.g[id];
+
+        if (s.toGoal[id] >= 0 && g + s.toGoal[id] < bestGoal)
+        {
+            bestGoal = g + s.toGoal[id];
+            goalVia = id;
+            push(bestGoal, -1);
+        }
+
+        auto relax = [&](int to, int cost)
+        {
+            if (s.visit[to] == CLOSED)
+                return;
+            int ng = g + cost;
+            if (s.visit[to] != OPEN || ng < s.g[to])
+            {
+                s.visit[to] = OPEN;
+                s.g[to] = ng;
+                s.parent[to] = id;
+                push(ng + octile(nodes[to].x, nodes[to].y, gx, gy), to);
+            }
+        };
+        relax(n.peer, 10);
+        for (const Edge &e : n.edges)
+            relax(e.to, e.cost);
+    }
+    for (int id : goalNodes)
+        s.toGoal[id] = -1;
+    if (!found)
+        return false;
+
+    // node chain start -> goal, each step either crosses an entrance or walks inside one cluster
+    s.chain.clear();
+    for (int id = goalVia; id >= 0; id = s.parent[id])
+        s.chain.push_back(id);
+    std::reverse(s.chain.begin(), s.chain.end());
+
+    outPath.clear();
+    int x = sx, y = sy, c = cs;
+    for (size_t k = 0; k < s.chain.size(); ++k)
+    {
+        const Node &n = nodes[s.chain[k]];
+        if (k > 0 && n.cluster != c)
+            outPath.push_back(map.tileToWorldCenter(n.x, n.y)); // through the entrance
+        else
+            appendLocalPath(map, n.cluster, x, y, n.x, n.y, s, outPath, expanded);
+        x = n.x;
+        y = n.y;
+        c = n.cluster;
+    }
+    appendLocalPath(map, cg, x, y, gx, gy, s, outPath, expanded);
+    return true;
+}
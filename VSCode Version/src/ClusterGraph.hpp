@@ -0,0 +1,107 @@
+#pragma once
+#include <raylib.h>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+class Tilemap;
+
+/*
+Abstract graph for long paths (HPA*). The map is cut into CLUSTER x CLUSTER tile clusters.
+Wherever floor lines up on both sides of a cluster border there's an entrance, with a node
+on each side (one in the middle of short openings, one at each end of long ones). Nodes in
+the same cluster are linked by the cost of walking between them without leaving it.
+
+A long search runs over those nodes only, then each step is turned back into tiles by a
+small search inside one cluster, so only the clusters along the chosen corridor get looked at.
+Paths use the same moves as Pathfinder (8 way, 10/14, no corner cutting) and come out close
+to the shortest, not always exactly.
+
+Carving only opens walls inside the changed box, so update() redoes the clusters holding
+it, the borders it touches and the links in the clusters across those borders.
+*/
+class ClusterGraph
+{
+public:
+    static const int CLUSTER = 16;        // tiles per cluster side
+    static const int LONG_ENTRANCE = 6;   // openings this wide get two nodes instead of one
+    static const int LONG_QUERY_TILES = 64; // Pathfinder only goes through the graph past this far
+
+    // search state, Pathfinder keeps one per thread so the graph itself is only read
+    struct Search
+    {
+        std::vector<int> g, parent, toGoal;
+        std::vector<uint32_t> visit;
+        uint32_t stamp = 0;
+        std::vector<std::pair<int, int>> heap; // (f, node), -1 is the goal
+        std::vector<int> startCost, chain, targets;
+        // one cluster's tiles with a ring of wall round them, see padIndex
+        std::vector<uint8_t> grid;
+        std::vector<int> cost;
+        std::vector<uint8_t> from;
+        std::vector<uint16_t> buckets[8]; // cells by cost/2, round robin (steps are 5 and 7)
+        std::vector<int> route;
+    };
+
+    // cells: one byte per tile, nonzero = wall
+    void build(const uint8_t *cells, int width, int height);
+    // tiles inside [minX,maxX]x[minY,maxY] changed in cells
+    void update(const uint8_t *cells, int minX, int minY, int maxX, int maxY);
+
+    bool ready() const { return clusterW > 0; }
+    int nodeCount() const { return liveNodes; }
+    size_t memoryBytes() const;
+
+    // tile path from (sx,sy) to (gx,gy), start excluded like Pathfinder. expanded counts graph nodes
+    bool findPath(const Tilemap &map, int sx, int sy, int gx, int gy, std::vector<Vector2> &outPath, Search &s,
+                  int &expanded) const;
+
+private:
+    enum Side : uint8_t
+    {
+        RIGHT,
+        BOTTOM,
+        LEFT,
+        TOP
+    };
+    struct Edge
+    {
+        int to, cost;
+    };
+    struct Node
+    {
+        int x, y, cluster;
+        int peer; // node on the other side of the entrance, one straight step away
+        Side side;
+        std::vector<Edge> edges; // same cluster
+    };
+
+    int width = 0, height = 0;
+    int clusterW = 0, clusterH = 0;
+    std::vector<Node> nodes;
+    std::vector<int> freeNodes;
+    std::vector<std::vector<int>> clusterNodes;
+    int liveNodes = 0;
+    Search linkScratch; // for build/update
+
+    static const int PAD = CLUSTER + 2;
+
+    int clusterOf(int x, int y) const { return (y / CLUSTER) * clusterW + x / CLUSTER; }
+    // cell of a map tile in its cluster's padded grid
+    static int padIndex(int x, int y) { return (y % CLUSTER + 1) * PAD + x % CLUSTER + 1; }
+    void clusterRect(int c, int &x0, int &y0, int &x1, int &y1) const;
+    int addNode(int x, int y, Side side);
+    void removeNode(int id);
+    void removeSide(int cluster, Side side);
+    void scanBorder(const uint8_t *cells, int cluster, Side side); // RIGHT or BOTTOM, makes nodes on both sides
+    void linkCluster(const uint8_t *cells, int cluster);
+
+    // copies cluster c into s.grid, everything outside it is wall
+    void loadCluster(const uint8_t *cells, int c, Search &s) const;
+    // Dijkstra over s.grid from a padded cell into s.cost/s.from (-1 = not reached), stops once
+    // every cell in s.targets is settled (never, if it's empty). returns cells settled
+    static int localSearch(int start, Search &s);
+    void appendLocalPath(const Tilemap &map, int c, int fx, int fy, int tx, int ty, Search &s,
+                         std::vector<Vector2> &out, int &expanded) const;
+};
@@ -15,25 +15,10 @@ void Bullet::update(float dt, const Tilemap &world)
         pos.y += step.y;
 
         // wall collision kills bullet
-        int minTx = (int)((pos.x - radius) / Tilemap::TILE_SIZE);
-        int minTy = (int)((pos.y - radius) / Tilemap::TILE_SIZE);
-        int maxTx = (int)((pos.x + radius) / Tilemap::TILE_SIZE);
-        int maxTy = (int)((pos.y + radius) / Tilemap::TILE_SIZE);
-
-        for (int ty = minTy; ty <= maxTy; ++ty)
+        if (world.circleHitsWall(pos, radius))
         {
-            for (int tx = minTx; tx <= maxTx; ++tx)
-            {
-                if (!world.isWall(tx, ty))
-                    continue;
-                Rectangle t{(float)tx * Tilemap::TILE_SIZE, (float)ty * Tilemap::TILE_SIZE,
-                            (float)Tilemap::TILE_SIZE, (float)Tilemap::TILE_SIZE};
-                if (CheckCollisionCircleRec(pos, radius, t))
-                {
-                    alive = false;
-                    return;
-                }
-            }
+            alive = false;
+            return;
         }
     }
 }
@@ -0,0 +1,201 @@
+#include "FloorComponents.hpp"
+#include <utility>
+
+void FloorComponents::build(const uint8_t *cells, int w, int h)
+{
+    width = w;
+    height = h;
+    rows.assign(height, {});
+    parent.clear();
+    sizes.clear();
+
+    // pass 1: the runs of each row inside the outer ring, joined to the runs they touch above.
+    // every run starts as its own label, the lowest label stays the root
+    for (int y = 1; y < height - 1; ++y)
+    {
+        const uint8_t *cell = cells + (size_t)y * width;
+        const std::vector<Run> &above = rows[y - 1];
+        std::vector<Run> &runs = rows[y];
+        size_t a = 0;
+        for (int x = 1; x < width - 1;)
+        {
+            if (cell[x])
+            {
+                ++x;
+                continue;
+            }
+            Run r{x, x, (int)parent.size()};
+            while (x < width - 1 && !cell[x])
+                r.x1 = x++;
+            parent.push_back(r.label);
+            sizes.push_back(r.x1 - r.x0 + 1);
+
+            while (a < above.size() && above[a].x1 < r.x0)
+                ++a;
+            for (size_t k = a; k < above.size() && above[k].x0 <= r.x1; ++k)
+                join(findRoot(above[k].label), findRoot(r.label));
+            runs.push_back(r);
+        }
+    }
+
+    // pass 2: number the regions by their first run, which is RegionLabeler's order
+    std::vector<int> finalId(parent.size(), -1);
+    std::vector<int> finalSizes;
+    regions = 0;
+    for (int i = 0; i < (int)parent.size(); ++i)
+    {
+        if (findRoot(i) == i)
+        {
+            finalId[i] = regions++;
+            finalSizes.push_back(sizes[i]);
+        }
+    }
+    for (auto &runs : rows)
+        for (Run &r : runs)
+            r.label = finalId[findRoot(r.label)];
+
+    // one label per region from here on, not per run
+    std::vector<int> roots(regions);
+    for (int i = 0; i < regions; ++i)
+        roots[i] = i;
+    parent.swap(roots);
+    sizes.swap(finalSizes);
+    merges = 0;
+}
+
+int FloorComponents::findRoot(int a)
+{
+    int root = a;
+    while (parent[root] != root)
+        root = parent[root];
+    while (parent[a] != root)
+    {
+        int next = parent[a];
+        parent[a] = root;
+        a = next;
+    }
+    return root;
+}
+
+int FloorComponents::join(int a, int b)
+{
+    if (a == b)
+        return a;
+    // lower id stays the root, same as the labeller
+    if (b < a)
+        std::swap(a, b);
+    parent[b] = a;
+    sizes[a] += sizes[b];
+    return a;
+}
+
+int FloorComponents::runAt(int x, int y) const
+{
+    if ((unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height)
+        return -1;
+    const std::vector<Run> &row = rows[y];
+    auto it = std::upper_bound(row.begin(), row.end(), x, [](int v, const Run &r)
+                               { return v < r.x0; });
+    if (it == row.begin() || x > (it - 1)->x1)
+        return -1;
+    return (int)(it - row.begin()) - 1;
+}
+
+void FloorComponents::open(int x, int y)
+{
+    if ((unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height || runAt(x, y) >= 0)
+        return;
+    std::vector<Run> &row = rows[y];
+    // first run past x, the one before it may end right at x-1
+    size_t next = std::upper_bound(row.begin(), row.end(), x, [](int v, const Run &r)
+                                   { return v < r.x0; }) -
+                  row.begin();
+    const bool left = next > 0 && row[next - 1].x1 == x - 1;
+    const bool right = next < row.size() && row[next].x0 == x + 1;
+
+    // merge the regions of every floor neighbour. floor that isn't in a run yet is later in
+    // the same carve, it joins us then
+    int mine = -1;
+    auto touch = [&](int label)
+    {
+        int r = findRoot(label);
+        if (mine < 0)
+            mine = r;
+        else if (r != mine)
+        {
+            mine = join(mine, r);
+            regions--;
+            merges++;
+        }
+    };
+    if (left)
+        touch(row[next - 1].label);
+    if (right)
+        touch(row[next].label);
+    for (int ny : {y - 1, y + 1})
+    {
+        int k = runAt(x, ny);
+        if (k >= 0)
+            touch(rows[ny][k].label);
+    }
+    if (mine < 0)
+    {
+        // a pocket of its own (a carve that didn't reach any floor)
+        mine = (int)parent.size();
+        parent.push_back(mine);
+        sizes.push_back(0);
+        regions++;
+    }
+    sizes[mine]++;
+
+    // grow or join the runs beside it, or start a new one
+    if (left && right)
+    {
+        row[next - 1].x1 = row[next].x1;
+        row[next - 1].label = mine;
+        row.erase(row.begin() + next);
+    }
+    else if (left)
+    {
+        row[next - 1].x1 = x;
+        row[next - 1].label = mine;
+    }
+    else if (right)
+    {
+        row[next].x0 = x;
+        row[next].label = mine;
+    }
+    else
+        row.insert(row.begin() + next, Run{x, x, mine});
+}
+
+int FloorComponents::largest() const
+{
+    int best = -1;
+    for (int i = 0; i < (int)parent.size(); ++i)
+        if (parent[i] == i && (best < 0 || sizes[i] > sizes[best]))
+            best = i;
+    return best;
+}
+
+int FloorComponents::runCount() const
+{
+    size_t n = 0;
+    for (auto &runs : rows)
+        n += runs.size();
+    return (int)n;
+}
+
+size_t FloorComponents::memoryBytes() const
+{
+    size_t bytes = rows.capacity() * sizeof(std::vector<Run>) + (parent.capacity() + sizes.capacity()) * sizeof(int);
+    for (auto &runs : rows)
+        bytes += runs.capacity() * sizeof(Run);
+    return bytes;
+}
+
+void FloorComponents::settle()
+{
+    for (int i = 0; i < (int)parent.size(); ++i)
+        parent[i] = findRoot(i);
+}
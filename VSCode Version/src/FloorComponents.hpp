@@ -0,0 +1,76 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/*
+Connected floor regions kept up to date while the map is carved, so "can I get from a to b"
+is two lookups instead of a search that floods the whole cave before it gives up.
+
+Regions are stored per run (a horizontal stretch of floor in one row) rather than per tile,
+so the memory goes with how broken up the cave is, not with its area: a 1024^2 cave has a
+few hundred thousand runs against a million tiles. at() is a binary search along one row.
+
+build() labels the runs, joining runs that overlap in the rows above and below in a
+union-find (same regions and ids as RegionLabeler). Carving only ever turns walls into floor,
+so regions can join but never split: open() grows or joins the runs beside a new tile and
+merges the regions it touches. settle() flattens that afterwards so lookups don't chase
+parents and stay safe to read from any thread.
+
+4-connected like RegionLabeler. Pathfinder's diagonals need both side tiles open, so they
+never join anything the straight moves don't.
+*/
+class FloorComponents
+{
+public:
+    // cells: one byte per tile, nonzero = wall
+    void build(const uint8_t *cells, int width, int height);
+    // tile (x,y) just turned to floor. call settle() once the batch is done
+    void open(int x, int y);
+    void settle();
+
+    // region id of a tile, -1 for walls and outside the map
+    inline int at(int x, int y) const
+    {
+        if ((unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height)
+            return -1;
+        const std::vector<Run> &row = rows[y];
+        // the last run starting at or before x
+        auto it = std::upper_bound(row.begin(), row.end(), x, [](int v, const Run &r)
+                                   { return v < r.x0; });
+        if (it == row.begin() || x > (--it)->x1)
+            return -1;
+        return parent[it->label];
+    }
+    inline bool connected(int ax, int ay, int bx, int by) const
+    {
+        int a = at(ax, ay);
+        return a >= 0 && a == at(bx, by);
+    }
+
+    int regionCount() const { return regions; } // separate regions right now
+    int largest() const;                         // id of the biggest region (the main cave), -1 if no floor
+    long mergeCount() const { return merges; }   // joins since build()
+    int runCount() const;
+    size_t memoryBytes() const;
+
+private:
+    struct Run
+    {
+        int x0, x1; // inclusive
+        int label;  // index into parent (not always a root until settle())
+    };
+
+    int width = 0, height = 0;
+    std::vector<std::vector<Run>> rows; // per row, sorted by x0
+    std::vector<int> parent;
+    std::vector<int> sizes; // tiles per region, only right at roots
+    int regions = 0;
+    long merges = 0;
+
+    int findRoot(int a);
+    int join(int a, int b); // merges two roots, returns the one kept
+    // index of the run holding x in row y, -1 if none
+    int runAt(int x, int y) const;
+};
@@ -0,0 +1,151 @@
+#include "FlowFieldService.hpp"
+#include "Tilemap.hpp"
+#include <algorithm>
+#include <chrono>
+
+// same step order as Pathfinder, the first four are straight
+static const int DIR8[8][2] = {
+    {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1}};
+// index of the step going the other way
+static const uint8_t OPPOSITE[8] = {1, 0, 3, 2, 7, 6, 5, 4};
+
+void FlowFieldService::clear()
+{
+    fields.clear();
+    useCounter = 0;
+    stats = {};
+    lastTick = {};
+}
+
+void FlowFieldService::beginTick()
+{
+    lastTick = stats;
+    stats.fieldsBuiltLastTick = 0;
+    stats.lookupsLastTick = 0;
+    stats.msLastTick = 0.0;
+}
+
+FlowFieldService::Field *FlowFieldService::fieldFor(const Tilemap &world, Vector2 goal)
+{
+    int gx, gy;
+    world.worldToTile(goal, gx, gy);
+    if (world.isWall(gx, gy))
+        return nullptr;
+
+    Field *slot = nullptr;
+    for (Field &f : fields)
+    {
+        if (f.gx == gx && f.gy == gy && f.editVersion == world.getEditVersion())
+        {
+            f.lastUsed = ++useCounter;
+            return &f;
+        }
+    }
+
+    // new goal, take a free slot or the one used longest ago
+    if ((int)fields.size() < MAX_FIELDS)
+    {
+        fields.emplace_back();
+        slot = &fields.back();
+    }
+    else
+    {
+        slot = &*std::min_element(fields.begin(), fields.end(), [](const Field &a, const Field &b)
+                                  { return a.lastUsed < b.lastUsed; });
+    }
+    slot->gx = gx;
+    slot->gy = gy;
+    slot->editVersion = world.getEditVersion();
+    slot->lastUsed = ++useCounter;
+
+    auto t0 = std::chrono::steady_clock::now();
+    build(*slot, world);
+    stats.msLastTick += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    stats.fieldsBuiltLastTick++;
+    stats.fieldsBuilt++;
+    return slot;
+}
+
+void FlowFieldService::build(Field &f, const Tilemap &world)
+{
+    const int W = world.getWidth(), H = world.getHeight();
+    f.x0 = std::max(0, f.gx - radius);
+    f.y0 = std::max(0, f.gy - radius);
+    f.w = std::min(W - 1, f.gx + radius) - f.x0 + 1;
+    f.h = std::min(H - 1, f.gy + radius) - f.y0 + 1;
+    f.toward.assign((size_t)f.w * f.h, NONE);
+    cost.assign((size_t)f.w * f.h, -1);
+    for (auto &b : buckets)
+        b.clear();
+
+    const uint8_t *tiles = world.data();
+    auto open = [&](int x, int y)
+    { return x >= f.x0 && y >= f.y0 && x < f.x0 + f.w && y < f.y0 + f.h && !tiles[(size_t)y * W + x]; };
+
+    // Dijkstra out from the goal. steps cost 5 or 7 halves so eight buckets taken in turn
+    // keep everything in cost order without a heap
+    int start = (f.gy - f.y0) * f.w + (f.gx - f.x0);
+    cost[start] = 0;
+    f.toward[start] = GOAL;
+    buckets[0].push_back(start);
+    int pending = 1;
+    for (int half = 0; pending > 0; ++half)
+    {
+        std::vector<int> &bucket = buckets[half & 7];
+        for (size_t b = 0; b < bucket.size(); ++b)
+        {
+            int i = bucket[b], d = half * 2;
+            pending--;
+            if (d > cost[i])
+                continue;
+            int x = f.x0 + i % f.w, y = f.y0 + i / f.w;
+            for (int k = 0; k < 8; ++k)
+            {
+                int nx = x + DIR8[k][0], ny = y + DIR8[k][1];
+                if (!open(nx, ny))
+                    continue;
+                if (k >= 4 && (!open(nx, y) || !open(x, ny)))
+                    continue;
+                int ni = (ny - f.y0) * f.w + (nx - f.x0), nd = d + (k >= 4 ? 14 : 10);
+                if (cost[ni] < 0 || nd < cost[ni])
+                {
+                    cost[ni] = nd;
+                    f.toward[ni] = OPPOSITE[k]; // we got here going k, so the goal is back the other way
+                    buckets[(nd / 2) & 7].push_back(ni);
+                    pending++;
+                }
+            }
+        }
+        bucket.clear();
+    }
+}
+
+uint8_t FlowFieldService::stepAt(const Field &f, const Tilemap &world, Vector2 from, int &tx, int &ty) const
+{
+    world.worldToTile(from, tx, ty);
+    if (tx < f.x0 || ty < f.y0 || tx >= f.x0 + f.w || ty >= f.y0 + f.h)
+        return NONE;
+    return f.toward[(size_t)(ty - f.y0) * f.w + (tx - f.x0)];
+}
+
+bool FlowFieldService::covers(const Tilemap &world, Vector2 goal, Vector2 from)
+{
+    Field *f = fieldFor(world, goal);
+    int tx, ty;
+    return f && stepAt(*f, world, from, tx, ty) != NONE;
+}
+
+bool FlowFieldService::nextStep(const Tilemap &world, Vector2 goal, Vector2 from, Vector2 &outNext)
+{
+    stats.lookups++;
+    stats.lookupsLastTick++;
+    Field *f = fieldFor(world, goal);
+    if (!f)
+        return false;
+    int tx, ty;
+    uint8_t k = stepAt(*f, world, from, tx, ty);
+    if (k == NONE)
+        return false;
+    outNext = (k == GOAL) ? goal : world.tileToWorldCenter(tx + DIR8[k][0], ty + DIR8[k][1]);
+    return true;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <raylib.h>
+#include <cstdint>
+#include <vector>
+
+class Tilemap;
+
+/*
+Shared flow fields for hunters closing in on the same spot (the player, or the squad's
+last sighting). One Dijkstra runs outward from the goal over a square of RADIUS tiles
+around it, and every tile in it remembers which neighbour is one step closer. Any number
+of hunters can then read their next step in O(1) instead of each running A*.
+
+A field is kept until its goal moves to another tile or the map is carved, and up to
+MAX_FIELDS goals are kept at once (least recently used goes first). Hunters outside the
+square, or cut off from the goal, get nothing and should fall back to a normal path.
+Same moves as Pathfinder (8 way, 10/14, no corner cutting).
+*/
+class FlowFieldService
+{
+public:
+    static const int DEFAULT_RADIUS = 48; // tiles each side of the goal
+    static const int MAX_FIELDS = 8;
+
+    struct Stats
+    {
+        int fieldsBuiltLastTick = 0;
+        int lookupsLastTick = 0;
+        double msLastTick = 0.0; // spent building fields
+        long fieldsBuilt = 0;
+        long lookups = 0;
+    };
+
+    void setRadius(int tiles) { radius = tiles; }
+    void clear(); // new world, drops every field (stats too)
+    void beginTick(); // rolls the per tick stats over
+
+    // true if 'from' is inside the goal's field and can reach the goal
+    bool covers(const Tilemap &world, Vector2 goal, Vector2 from);
+    // centre of the next tile towards the goal, or the goal itself once on its tile.
+    // false when covers() would be
+    bool nextStep(const Tilemap &world, Vector2 goal, Vector2 from, Vector2 &outNext);
+
+    const Stats &getStats() const { return lastTick; }
+
+private:
+    static constexpr uint8_t GOAL = 0xFE, NONE = 0xFF;
+
+    struct Field
+    {
+        int gx = -1, gy = -1;
+        unsigned editVersion = 0;
+        int x0 = 0, y0 = 0, w = 0, h = 0; // the square, clipped to the map
+        std::vector<uint8_t> toward;      // DIR8 index one step closer, GOAL or NONE
+        uint64_t lastUsed = 0;
+    };
+
+    int radius = DEFAULT_RADIUS;
+    std::vector<Field> fields;
+    uint64_t useCounter = 0;
+
+    // build scratch
+    std::vector<int> cost;
+    std::vector<int> buckets[8];
+
+    Stats stats, lastTick;
+
+    Field *fieldFor(const Tilemap &world, Vector2 goal);
+    void build(Field &f, const Tilemap &world);
+    uint8_t stepAt(const Field &f, const Tilemap &world, Vector2 from, int &tx, int &ty) const;
+};
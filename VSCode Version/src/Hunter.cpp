@@ -27,11 +27,15 @@ static float rotateTowards(float current, float target, float maxStep)
     return wrapPi(current + d);
 }
 
-void Hunter::spawnAt(const Tilemap &world, Vector2 p)
+void Hunter::spawnAt(const Tilemap &world, Vector2 p, std::mt19937 &rng)
 {
     pos = p;
     patrolHome = p;
-    pickNewPatrolTarget(world);
+    auto rand = [&](int lo, int hi)
+    { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+    float a = rand(0, 628) / 100.0f;
+    float r = (float)rand(80, (int)patrolRadius);
+    setPatrolTarget(world, a, r, rand(120, 240) / 60.0f);
 }
 
 void Hunter::pickNewPatrolTarget(const Tilemap &world)
@@ -39,14 +43,55 @@ void Hunter::pickNewPatrolTarget(const Tilemap &world)
     // pick a random point near home
     float a = GetRandomValue(0, 628) / 100.0f;
     float r = (float)GetRandomValue(80, (int)patrolRadius);
-    Vector2 goal = {patrolHome.x + cosf(a) * r, patrolHome.y + sinf(a) * r};
+    setPatrolTarget(world, a, r, GetRandomValue(120, 240) / 60.0f); // 2-4 seconds
+}
+
+void Hunter::setPatrolTarget(const Tilemap &world, float angle, float dist, float retargetTime)
+{
+    Vector2 goal = {patrolHome.x + cosf(angle) * dist, patrolHome.y + sinf(angle) * dist};
     requestPathTo(world, goal);
-    retargetTimer = GetRandomValue(120, 240) / 60.0f; // 2-4 seconds
+    retargetTimer = retargetTime;
 }
 
 void Hunter::requestPathTo(const Tilemap &world, Vector2 goal)
 {
-    world.findPath(pos, goal, path);
+    if (state == State::Patrol)
+        planner.reset(); // patrol goals jump around, no point keeping the search
+    else if (incrementalChase && planner.plan(world, pos, goal, tilePath, PLAN_BUDGET))
+    {
+        // done on the spot, capped at PLAN_BUDGET queue pops. a repair that needs more (a restart,
+        // a big carve) stops there and the scheduler below answers while it catches up next time
+        if (pathScheduler)
+            pathScheduler->cancel(id); // an older answer would overwrite this one
+        path.pull(world, pos, tilePath, radius);
+        pathIndex = 0;
+        return;
+    }
+
+    if (pathScheduler)
+    {
+        // answered on a later tick, keep walking the old path till then
+        PathScheduler::Priority pr = (state == State::Chase)    ? PathScheduler::Priority::Chase
+                                     : (state == State::Search) ? PathScheduler::Priority::Search
+                                                                : PathScheduler::Priority::Patrol;
+        pathScheduler->request(id, pos, goal, pr);
+        return;
+    }
+    if (world.findPath(pos, goal, tilePath))
+    {
+        path.pull(world, pos, tilePath, radius);
+        pathIndex = 0;
+    }
+}
+
+void Hunter::collectPath(const Tilemap &world)
+{
+    if (!pathScheduler || !pathScheduler->takeResult(id, tilePath))
+        return;
+
+    // the path starts where we were when we asked, pulling the string from where we are
+    // now skips whatever we've already walked past
+    path.pull(world, pos, tilePath, radius);
     pathIndex = 0;
 }
 
@@ -59,12 +104,53 @@ void Hunter::followPath(const Tilemap &world, float dt)
     }
     Vector2 target = path[pathIndex];
     Vector2 to = {target.x - pos.x, target.y - pos.y};
-    float d = len(to);
-    if (d < 6.0f)
+    if (len(to) < 6.0f)
     {
         pathIndex++;
         return;
     }
+    moveTowards(world, target, dt);
+}
+
+bool Hunter::inCone(Vector2 pp, float range) const
+{
+    Vector2 toP{pp.x - pos.x, pp.y - pos.y};
+    float d = len(toP);
+    if (d > range || d <= 1e-4f)
+        return false;
+    float cosHalf = cosf((fovDeg * 0.5f) * (PI / 180.0f));
+    return cosf(facingRad) * toP.x + sinf(facingRad) * toP.y >= cosHalf * d;
+}
+
+bool Hunter::canSeePlayerCone(const Tilemap &world, Vector2 pp) const
+{
+    return inCone(pp, sightRange) && lineToPlayer(world, pp);
+}
+
+bool Hunter::lineToPlayer(const Tilemap &world, Vector2 pp) const
+{
+    // the field is worked out from the player's tile, only trust it if it's still for pp and reaches us
+    if (playerSight && playerSight->covers(world, pp, pos))
+        return playerSight->visible(world, pos);
+    return world.hasLineOfSight(pos, pp);
+}
+
+bool Hunter::followFlow(const Tilemap &world, Vector2 goal, float dt)
+{
+    // the field hands out the next tile centre, one step at a time
+    Vector2 next;
+    if (!flowFields->nextStep(world, goal, pos, next))
+        return false;
+    Vector2 to = {next.x - pos.x, next.y - pos.y};
+    if (len(to) >= 1.0f)
+        moveTowards(world, next, dt);
+    return true;
+}
+
+void Hunter::moveTowards(const Tilemap &world, Vector2 target, float dt)
+{
+    Vector2 to = {target.x - pos.x, target.y - pos.y};
+    float d = len(to);
     Vector2 dir = {to.x / d, to.y / d};
 
     // smooth rotation towards path
@@ -86,21 +172,18 @@ void Hunter::update(float dt, const Tilemap &world, const Player &player, SquadI
     if (memory > 0.0f)
         memory -= dt;
 
+    // pick up a path the scheduler finished since last tick
+    collectPath(world);
+
     // sensing
     Vector2 pp = player.getPosition();
     Vector2 toP = {pp.x - pos.x, pp.y - pos.y};
     float distP = sqrtf(toP.x * toP.x + toP.y * toP.y);
     Vector2 dirToP = (distP > 1e-4f) ? Vector2{toP.x / distP, toP.y / distP} : Vector2{0, 0};
 
-    Vector2 fwd = {cosf(facingRad), sinf(facingRad)};
-    float cosHalf = cosf((fovDeg * 0.5f) * (PI / 180.0f));
-
-    bool inCone = (distP <= sightRange) && (fwd.x * dirToP.x + fwd.y * dirToP.y >= cosHalf);
-    bool seePlayer = inCone && world.hasLineOfSight(pos, pp);
-
-    bool proximity = (distP <= proximityRange);
-    if (proximity)
-        seePlayer = true;
+    // the squad's perception pass already looked this tick, else look ourselves
+    const HunterPerception::Percept *seen = perception ? perception->get(id) : nullptr;
+    bool seePlayer = seen ? seen->seesPlayer : (distP <= proximityRange || canSeePlayerCone(world, pp));
 
     // share squad intel
     if (seePlayer)
@@ -195,18 +278,20 @@ void Hunter::update(float dt, const Tilemap &world, const Player &player, SquadI
     if (repathTimer <= 0.0f)
     {
         repathTimer = repathInterval;
+        bool wantPath = true;
+        Vector2 goal{};
         if (seePlayer)
-        {
-            requestPathTo(world, pp);
-        }
+            goal = pp;
         else if (hasSharedIntel)
-        {
-            requestPathTo(world, intel.spot);
-        }
+            goal = intel.spot;
         else if (state == State::Search && hasPersonalIntel)
-        {
-            requestPathTo(world, lastSeen);
-        }
+            goal = lastSeen;
+        else
+            wantPath = false;
+
+        // inside a shared flow field there's nothing to search for, we just read it
+        if (wantPath && !(flowFields && flowFields->covers(world, goal, pos)))
+            requestPathTo(world, goal);
     }
 
     // find movement target
@@ -279,10 +364,12 @@ void Hunter::update(float dt, const Tilemap &world, const Player &player, SquadI
             followPath(world, dt);
             break;
         case State::Chase:
-            followPath(world, dt);
+            if (!(knowsTarget && flowFields && followFlow(world, trackPos, dt)))
+                followPath(world, dt);
             break; // chasing last fix
         case State::Search:
-            followPath(world, dt);
+            if (!(knowsTarget && flowFields && followFlow(world, trackPos, dt)))
+                followPath(world, dt);
             break;
         }
     }
@@ -373,6 +460,16 @@ bool Hunter::hasFriendlyInLine(const std::vector<Hunter> &squad, int selfIndex,
     };
 
     float safety2 = safety * safety;
+    if (squadHash && squadHash->size() == (int)squad.size())
+    {
+        bool blocked = false;
+        squadHash->segment(start, end, safety, [&](int i)
+                           {
+            const Hunter &h = squad[i];
+            if (i != selfIndex && h.isAlive() && segDist2(start, end, h.pos) <= safety2)
+                blocked = true; });
+        return blocked;
+    }
     for (int i = 0; i < (int)squad.size(); ++i)
     {
         if (i == selfIndex)
@@ -404,13 +501,11 @@ bool Hunter::tryShoot(float dt, const Tilemap &world, const Player &player,
     if (dist > shootRange)
         return false;
 
+    const HunterPerception::Percept *seen = perception ? perception->get(id) : nullptr;
+    if (seen ? !seen->canShoot : !(inCone(pp, shootRange) && lineToPlayer(world, pp)))
+        return false;
     Vector2 fwd{cosf(facingRad), sinf(facingRad)};
     Vector2 dir = (dist > 1e-4f) ? Vector2{toP.x / dist, toP.y / dist} : Vector2{0, 0};
-    float cosHalf = cosf((fovDeg * 0.5f) * (PI / 180.0f));
-    if (fwd.x * dir.x + fwd.y * dir.y < cosHalf)
-        return false;
-    if (!world.hasLineOfSight(pos, pp))
-        return false;
 
     // friendly fire avoidance
     Vector2 end{pos.x + dir.x * (dist + 60.0f), pos.y + dir.y * (dist + 60.0f)};
@@ -1,9 +1,17 @@
 #pragma once
 #include <raylib.h>
 #include <vector>
+#include <random>
 #include "Combat.hpp"
 #include "Player.hpp"
 #include "Tilemap.hpp"
+#include "PathScheduler.hpp"
+#include "FlowFieldService.hpp"
+#include "IncrementalPlanner.hpp"
+#include "WaypointBuffer.hpp"
+#include "VisibilityField.hpp"
+#include "HunterPerception.hpp"
+#include "SpatialHash.hpp"
 
 struct SquadIntel
 {
@@ -22,7 +30,7 @@ public:
     };
 
     Vector2 pos{};
-    float radius = 12.0f;
+    float radius = 12.0f; // under half a tile, fits down every corridor
     float speed = 120.0f;
 
     // Health
@@ -52,7 +60,7 @@ public:
     int burstLeft = 0;
     float shootTimer = 0.0f;
 
-    bool canSeePlayerCone(const Tilemap &world, Vector2 pp) const;
+    bool canSeePlayerCone(const Tilemap &world, Vector2 pp) const; // in the fov out to sightRange, and a clear line
     bool hasFriendlyInLine(const std::vector<Hunter> &squad, int selfIndex,
                            Vector2 start, Vector2 end, float safety) const;
     bool tryShoot(float dt, const Tilemap &world, const Player &player,
@@ -63,13 +71,23 @@ public:
     float proximityRange = 70.0f;
     float fovDeg = 70.0f;
     float sightRange = 520.0f;
+    const VisibilityField *playerSight = nullptr; // tiles that see the player this tick, null = cast a ray
+    const HunterPerception *perception = nullptr; // squad wide sensing done before we update, null = look ourselves
+    const SpatialHash *squadHash = nullptr;       // the squad by index, for friendly fire checks. null = scan them all
     float facingRad = 0.0f;
     float loseSightTime = 2.0f;
     float memory = 0.0f;
     Vector2 lastSeen{};
 
     // Pathing
-    std::vector<Vector2> path;
+    int id = -1;                            // stable id for the path scheduler
+    PathScheduler *pathScheduler = nullptr; // null = search on the spot
+    FlowFieldService *flowFields = nullptr; // shared fields for chasing/searching, null = own paths only
+    bool incrementalChase = true;           // repair our own D* Lite search while chasing/searching
+    static const int PLAN_BUDGET = 500;     // D* Lite queue pops per replan on the main thread
+    IncrementalPlanner planner;
+    WaypointBuffer path;           // corners only
+    std::vector<Vector2> tilePath; // what the search gave, one per tile (kept for its capacity)
     int pathIndex = 0;
     float repathTimer = 0.0f;
     float repathInterval = 0.25;
@@ -87,7 +105,7 @@ public:
     float strafeSpeed = 90.0f;
     float turnRate = 6.0f;
 
-    void spawnAt(const Tilemap &world, Vector2 p);
+    void spawnAt(const Tilemap &world, Vector2 p, std::mt19937 &rng); // first patrol target from rng, same per seed
     void update(float dt, const Tilemap &world, const Player &player, SquadIntel &intel);
     void draw() const;
     void drawFOV() const;
@@ -95,6 +113,12 @@ public:
 
 private:
     void requestPathTo(const Tilemap &world, Vector2 goal);
+    void collectPath(const Tilemap &world);
     void followPath(const Tilemap &world, float dt);
+    bool followFlow(const Tilemap &world, Vector2 goal, float dt); // false if the field doesn't reach us
+    bool inCone(Vector2 pp, float range) const;
+    bool lineToPlayer(const Tilemap &world, Vector2 pp) const;     // shared field when it's for pp, else a ray
+    void moveTowards(const Tilemap &world, Vector2 target, float dt);
     void pickNewPatrolTarget(const Tilemap &world);
+    void setPatrolTarget(const Tilemap &world, float angle, float dist, float retargetTime);
 };
\ No newline at end of file
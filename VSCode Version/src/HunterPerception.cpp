@@ -0,0 +1,188 @@
+#include "HunterPerception.hpp"
+#include "Hunter.hpp"
+#include "Tilemap.hpp"
+#include "VisibilityField.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PERCEPTION_SSE 1
+#endif
+
+size_t HunterPerception::memoryBytes() const
+{
+    return percepts.capacity() * sizeof(Percept) +
+           (px.capacity() + py.capacity() + rangeSq.capacity() + dist.capacity() + dx.capacity() + dy.capacity() +
+            fx.capacity() + fy.capacity() + cosHalf.capacity() + cdist.capacity()) * sizeof(float) +
+           inCone.capacity() + (candidates.capacity() + rayOwner.capacity()) * sizeof(int) +
+           (rayFrom.capacity() + rayTo.capacity()) * sizeof(Vector2) + rayMask.capacity() * sizeof(uint64_t);
+}
+
+void HunterPerception::clear()
+{
+    percepts.clear();
+}
+
+// distance to the player for every lane, the ones in range go into candidates
+void HunterPerception::cull(int lanes, Vector2 p)
+{
+    candidates.clear();
+#ifdef PERCEPTION_SSE
+    const __m128 ppx = _mm_set1_ps(p.x), ppy = _mm_set1_ps(p.y);
+    for (int i = 0; i < lanes; i += 4)
+    {
+        __m128 x = _mm_sub_ps(ppx, _mm_loadu_ps(&px[i]));
+        __m128 y = _mm_sub_ps(ppy, _mm_loadu_ps(&py[i]));
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+        _mm_storeu_ps(&dist[i], _mm_sqrt_ps(d2));
+        int m = _mm_movemask_ps(_mm_cmple_ps(d2, _mm_loadu_ps(&rangeSq[i])));
+        for (int k = 0; m; ++k, m >>= 1)
+            if (m & 1)
+                candidates.push_back(i + k);
+    }
+#else
+    for (int i = 0; i < lanes; ++i)
+    {
+        float x = p.x - px[i], y = p.y - py[i];
+        float d2 = x * x + y * y;
+        dist[i] = sqrtf(d2);
+        if (d2 <= rangeSq[i])
+            candidates.push_back(i);
+    }
+#endif
+}
+
+// facing . (toP / dist) >= cos(fov/2) for the packed lanes, with dist moved over so there's no divide
+void HunterPerception::cone(int lanes)
+{
+#ifdef PERCEPTION_SSE
+    const __m128 tiny = _mm_set1_ps(1e-4f);
+    for (int i = 0; i < lanes; i += 4)
+    {
+        __m128 d = _mm_loadu_ps(&cdist[i]);
+        __m128 dot = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&fx[i]), _mm_loadu_ps(&dx[i])),
+                                _mm_mul_ps(_mm_loadu_ps(&fy[i]), _mm_loadu_ps(&dy[i])));
+        __m128 in = _mm_and_ps(_mm_cmpge_ps(dot, _mm_mul_ps(_mm_loadu_ps(&cosHalf[i]), d)), _mm_cmpgt_ps(d, tiny));
+        int m = _mm_movemask_ps(in);
+        for (int k = 0; k < 4; ++k)
+            inCone[i + k] = (m >> k) & 1;
+    }
+#else
+    for (int i = 0; i < lanes; ++i)
+        inCone[i] = cdist[i] > 1e-4f && fx[i] * dx[i] + fy[i] * dy[i] >= cosHalf[i] * cdist[i];
+#endif
+}
+
+void HunterPerception::update(const Tilemap &world, const std::vector<Hunter> &hunters, Vector2 p,
+                              const VisibilityField *field)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    const int n = (int)hunters.size();
+    int lanes = (n + 3) & ~3;
+    px.resize(lanes);
+    py.resize(lanes);
+    rangeSq.resize(lanes);
+    dist.resize(lanes);
+
+    // kept by hunter id, the squad vector loses the dead so ids and indices drift apart
+    int maxId = -1;
+    for (int i = 0; i < n; ++i)
+    {
+        const Hunter &h = hunters[i];
+        float r = std::max(h.sightRange, h.shootRange);
+        px[i] = h.pos.x;
+        py[i] = h.pos.y;
+        rangeSq[i] = (h.isAlive() && h.id >= 0) ? r * r : -1.0f; // -1 never passes
+        maxId = std::max(maxId, h.id);
+    }
+    for (int i = n; i < lanes; ++i)
+    {
+        px[i] = py[i] = 0.0f;
+        rangeSq[i] = -1.0f;
+    }
+    percepts.assign(maxId + 1, Percept{});
+
+    cull(lanes, p);
+    stats = {};
+    stats.hunters = n;
+    stats.inRange = (int)candidates.size();
+    for (int i = 0; i < n; ++i)
+    {
+        const Hunter &h = hunters[i];
+        if (!h.isAlive() || h.id < 0)
+            continue;
+        Percept &pc = percepts[h.id];
+        pc.valid = true;
+        pc.dist = dist[i];
+        pc.seesPlayer = dist[i] <= h.proximityRange; // close enough to hear, cone or not
+    }
+
+    // pack the ones in range, facings only get their cosf/sinf here
+    lanes = ((int)candidates.size() + 3) & ~3;
+    for (auto *v : {&dx, &dy, &fx, &fy, &cosHalf, &cdist})
+        v->resize(lanes);
+    inCone.resize(lanes);
+    float lastFov = -1.0f, lastCos = 0.0f;
+    for (int k = 0; k < lanes; ++k)
+    {
+        if (k >= (int)candidates.size())
+        {
+            dx[k] = dy[k] = fx[k] = fy[k] = cosHalf[k] = cdist[k] = 0.0f; // dist 0 fails the cone
+            continue;
+        }
+        const Hunter &h = hunters[candidates[k]];
+        if (h.fovDeg != lastFov)
+        {
+            lastFov = h.fovDeg;
+            lastCos = cosf((h.fovDeg * 0.5f) * (PI / 180.0f));
+        }
+        dx[k] = p.x - h.pos.x;
+        dy[k] = p.y - h.pos.y;
+        fx[k] = cosf(h.facingRad);
+        fy[k] = sinf(h.facingRad);
+        cosHalf[k] = lastCos;
+        cdist[k] = dist[candidates[k]];
+    }
+    cone(lanes);
+
+    // line of sight for whoever is left, the field first, one batch of rays for the rest
+    rayFrom.clear();
+    rayTo.clear();
+    rayOwner.clear();
+    auto seen = [&](int i)
+    {
+        const Hunter &h = hunters[i];
+        Percept &pc = percepts[h.id];
+        pc.seesPlayer = pc.seesPlayer || pc.dist <= h.sightRange;
+        pc.canShoot = pc.dist <= h.shootRange;
+    };
+    for (size_t k = 0; k < candidates.size(); ++k)
+    {
+        if (!inCone[k])
+            continue;
+        const int i = candidates[k];
+        stats.inCone++;
+        Vector2 from = hunters[i].pos;
+        if (field && field->covers(world, p, from))
+        {
+            if (field->visible(world, from))
+                seen(i);
+            continue;
+        }
+        rayFrom.push_back(from);
+        rayTo.push_back(p);
+        rayOwner.push_back(i);
+    }
+    stats.rays = (int)rayOwner.size();
+    if (!rayOwner.empty())
+    {
+        rayMask.assign((rayOwner.size() + 63) / 64, 0);
+        world.linesOfSight(rayFrom.data(), rayTo.data(), (int)rayOwner.size(), rayMask.data());
+        for (size_t k = 0; k < rayOwner.size(); ++k)
+            if ((rayMask[k / 64] >> (k % 64)) & 1)
+                seen(rayOwner[k]);
+    }
+
+    stats.msLastTick = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <raylib.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Hunter;
+class Tilemap;
+class VisibilityField;
+
+/*
+What every hunter can tell about the player this tick, worked out for the whole squad at
+once before any of them move. Three passes, cheapest first:
+  1. distance: squared distance against each hunter's longest range (sight or shoot)
+  2. cone: facing dot direction against cos(fov/2) for the ones in range, packed together
+     so the cosf/sinf of their facing is only paid for them
+  3. line of sight: only for the ones still in, from the shared VisibilityField when it
+     reaches them and one linesOfSight batch for the rest
+Both of the first two go four hunters at a time with SSE (a plain loop where SSE isn't
+there). Hunters read their Percept by id in update() and tryShoot() instead of each doing its own
+cosf/sqrtf/ray. The pose used is the one from the start of the tick.
+*/
+class HunterPerception
+{
+public:
+    struct Percept
+    {
+        bool valid = false;      // worked out this tick (alive, has an id)
+        bool seesPlayer = false; // cone + sightRange + LOS, or inside proximityRange
+        bool canShoot = false;   // cone + shootRange + LOS
+        float dist = 0.0f;       // to the player
+    };
+
+    struct Stats
+    {
+        int hunters = 0;
+        int inRange = 0; // past the distance cull
+        int inCone = 0;  // past the cone, LOS asked for these
+        int rays = 0;    // of those, not answered by the field
+        double msLastTick = 0.0;
+    };
+
+    void update(const Tilemap &world, const std::vector<Hunter> &hunters, Vector2 playerPos,
+                const VisibilityField *field = nullptr);
+    void clear();
+
+    const Percept *get(int id) const
+    {
+        return ((unsigned)id < (unsigned)percepts.size() && percepts[id].valid) ? &percepts[id] : nullptr;
+    }
+    const Stats &getStats() const { return stats; }
+    size_t memoryBytes() const;
+
+private:
+    std::vector<Percept> percepts;
+
+    // one lane per hunter, padded to a multiple of 4
+    std::vector<float> px, py, rangeSq, dist;
+    // one lane per hunter in range, same padding
+    std::vector<int> candidates;
+    std::vector<float> dx, dy, fx, fy, cosHalf, cdist;
+    std::vector<uint8_t> inCone;
+    std::vector<Vector2> rayFrom, rayTo;
+    std::vector<int> rayOwner;
+    std::vector<uint64_t> rayMask;
+
+    Stats stats;
+
+    void cull(int lanes, Vector2 p);
+    void cone(int lanes);
+};
@@ -0,0 +1,294 @@
+#include "IncrementalPlanner.hpp"
+#include "Tilemap.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+// same step order as Pathfinder, the first four are straight
+static const int DIR8[8][2] = {
+    {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1}};
+
+size_t IncrementalPlanner::memoryBytes() const
+{
+    return cells.size() * (sizeof(int) + sizeof(Cell) + 2 * sizeof(void *)) + open.capacity() * sizeof(Item) +
+           (opened.capacity() + route.capacity()) * sizeof(int);
+}
+
+void IncrementalPlanner::reset()
+{
+    active = false;
+    cells.clear();
+    open.clear();
+    route.clear();
+}
+
+IncrementalPlanner::Cell IncrementalPlanner::get(int i) const
+{
+    auto it = cells.find(i);
+    return it == cells.end() ? Cell{} : it->second;
+}
+
+int IncrementalPlanner::heuristic(int i) const
+{
+    int dx = abs(i % width - goal % width), dy = abs(i / width - goal / width);
+    return 10 * std::max(dx, dy) + 4 * std::min(dx, dy);
+}
+
+IncrementalPlanner::Item IncrementalPlanner::keyOf(int i, const Cell &c) const
+{
+    int m = std::min(c.g, c.rhs);
+    return {m + heuristic(i) + km, m, i};
+}
+
+void IncrementalPlanner::restart(const Tilemap &map, int rootIndex, int goalIndex)
+{
+    reset();
+    width = map.getWidth();
+    height = map.getHeight();
+    root = rootIndex;
+    goal = goalIndex;
+    km = 0;
+    editVersion = map.getEditVersion();
+    active = true;
+    cells[root].rhs = 0;
+    open.push_back(keyOf(root, cells[root]));
+}
+
+// best cost into tile i from any neighbour already reached, walls as in Pathfinder
+void IncrementalPlanner::updateVertex(const Tilemap &map, int i)
+{
+    if (i != root)
+    {
+        int x = i % width, y = i / width;
+        int best = INF, bestP = -1;
+        if (!map.isWall(x, y))
+        {
+            for (int k = 0; k < 8; ++k)
+            {
+                int px = x - DIR8[k][0], py = y - DIR8[k][1];
+                if (px < 0 || py < 0 || px >= width || py >= height)
+                    continue;
+                // no corner cutting, the same two tiles are beside the step either way round
+                if (k >= 4 && (map.isWall(px + DIR8[k][0], py) || map.isWall(px, py + DIR8[k][1])))
+                    continue;
+                int p = py * width + px;
+                if (p != root && map.isWall(px, py))
+                    continue;
+                Cell pc = get(p);
+                if (pc.g < INF && pc.g + (k >= 4 ? 14 : 10) < best)
+                {
+                    best = pc.g + (k >= 4 ? 14 : 10);
+                    bestP = p;
+                }
+            }
+        }
+        auto it = cells.find(i);
+        if (it == cells.end())
+        {
+            if (best == INF)
+                return; // never reached and still can't be
+            it = cells.emplace(i, Cell{}).first;
+        }
+        it->second.rhs = best;
+        it->second.parent = bestP;
+    }
+    Cell c = get(i);
+    if (c.g != c.rhs)
+    {
+        open.push_back(keyOf(i, c));
+        std::push_heap(open.begin(), open.end(), std::greater<Item>());
+    }
+}
+
+bool IncrementalPlanner::computeShortestPath(const Tilemap &map)
+{
+    std::greater<Item> cmp;
+    auto before = [](const Item &a, const Item &b)
+    { return a.k1 != b.k1 ? a.k1 < b.k1 : a.k2 < b.k2; };
+
+    while (!open.empty())
+    {
+        Cell gc = get(goal);
+        if (!before(open.front(), keyOf(goal, gc)) && gc.g == gc.rhs)
+            break;
+
+        // the budget counts every pop, a moved goal can leave lots of stale or outdated entries
+        if (++popped > budget)
+        {
+            // the queue still holds everything, the next plan() carries on from here
+            outOfBudget = true;
+            return false;
+        }
+        std::pop_heap(open.begin(), open.end(), cmp);
+        Item top = open.back();
+        open.pop_back();
+        int u = top.index;
+        Cell c = get(u);
+        if (c.g == c.rhs)
+            continue; // stale entry
+        Item now = keyOf(u, c);
+        if (before(top, now))
+        {
+            // key grew since it was queued (goal moved), put it back where it belongs
+            open.push_back(now);
+            std::push_heap(open.begin(), open.end(), cmp);
+            continue;
+        }
+        ++expanded;
+
+        int x = u % width, y = u / width;
+        if (c.g > c.rhs)
+        {
+            // got cheaper, pass it on to the neighbours
+            cells[u].g = c.rhs;
+            for (int k = 0; k < 8; ++k)
+            {
+                int nx = x + DIR8[k][0], ny = y + DIR8[k][1];
+                if (map.isWall(nx, ny))
+                    continue;
+                if (k >= 4 && (map.isWall(nx, y) || map.isWall(x, ny)))
+                    continue;
+                int s = ny * width + nx;
+                if (s == root)
+                    continue;
+                int nd = c.rhs + (k >= 4 ? 14 : 10);
+                Cell &sc = cells[s];
+                if (nd < sc.rhs)
+                {
+                    sc.rhs = nd;
+                    sc.parent = u;
+                    if (sc.g != sc.rhs)
+                    {
+                        open.push_back(keyOf(s, sc));
+                        std::push_heap(open.begin(), open.end(), cmp);
+                    }
+                }
+            }
+        }
+        else
+        {
+            // got dearer, everything that leaned on it has to look again
+            cells[u].g = INF;
+            updateVertex(map, u);
+            for (int k = 0; k < 8; ++k)
+            {
+                int nx = x + DIR8[k][0], ny = y + DIR8[k][1];
+                if (nx >= 0 && ny >= 0 && nx < width && ny < height)
+                    updateVertex(map, ny * width + nx);
+            }
+        }
+    }
+    return true;
+}
+
+bool IncrementalPlanner::extractRoute()
+{
+    // parents point back along the cheapest way in, once the goal is settled they lead to the root
+    route.clear();
+    Cell c = get(goal);
+    if (c.g >= INF)
+        return false;
+    int cur = goal;
+    int guard = c.g / 10 + 2;
+    while (cur != root)
+    {
+        if (--guard < 0 || c.parent < 0)
+            return false;
+        route.push_back(cur);
+        cur = c.parent;
+        c = get(cur);
+    }
+    std::reverse(route.begin(), route.end());
+    return true;
+}
+
+bool IncrementalPlanner::plan(const Tilemap &map, Vector2 from, Vector2 goalWorld, std::vector<Vector2> &outPath,
+                              int maxExpansions)
+{
+    expanded = 0;
+    popped = 0;
+    budget = maxExpansions;
+    repaired = false;
+    outOfBudget = false;
+    stats.plans++;
+    int sx, sy, gx, gy;
+    map.worldToTile(from, sx, sy);
+    map.worldToTile(goalWorld, gx, gy);
+    const int W = map.getWidth(), H = map.getHeight();
+    if (map.isWall(gx, gy))
+        return false;
+    if (sx < 0 || sy < 0 || sx >= W || sy >= H)
+        return false;
+    const int here = sy * W + sx, target = gy * W + gx;
+    // cut off from us, no point flooding the cave (Pathfinder can redirect it)
+    const FloorComponents &regions = map.getComponents();
+    if (regions.at(sx, sy) >= 0 && !regions.connected(sx, sy, gx, gy))
+        return false;
+
+    auto output = [&](size_t first)
+    {
+        outPath.clear();
+        for (size_t i = first; i < route.size(); ++i)
+            outPath.push_back(map.tileToWorldCenter(route[i] % width, route[i] / width));
+    };
+
+    bool repair = active && width == W && height == H &&
+                  std::max(abs(sx - root % W), abs(sy - root / W)) <= REROOT_TILES;
+    if (repair && map.getEditVersion() != editVersion)
+    {
+        opened.clear();
+        repair = map.openedSince(editVersion, opened);
+    }
+    if (repair)
+    {
+        if (target != goal)
+        {
+            // the goal moved, shift the keys rather than reorder the queue
+            km += heuristic(target);
+            goal = target;
+        }
+        if (map.getEditVersion() != editVersion)
+        {
+            // new floor, the tile and the diagonals it unblocked next to it
+            for (int t : opened)
+            {
+                updateVertex(map, t);
+                for (int k = 0; k < 8; ++k)
+                {
+                    int nx = t % W + DIR8[k][0], ny = t / W + DIR8[k][1];
+                    if (nx >= 0 && ny >= 0 && nx < W && ny < H)
+                        updateVertex(map, ny * W + nx);
+                }
+            }
+            editVersion = map.getEditVersion();
+        }
+
+        if (!computeShortestPath(map))
+            return false; // out of budget, keep the search for next time
+        if (extractRoute())
+        {
+            // the hunter has been walking the old path, carry on from its tile if it's on the new one
+            size_t first = 0;
+            if (here != root)
+            {
+                auto it = std::find(route.begin(), route.end(), here);
+                first = (it == route.end()) ? route.size() + 1 : (size_t)(it - route.begin()) + 1;
+            }
+            if (first <= route.size())
+            {
+                output(first);
+                repaired = true;
+                stats.repairs++;
+                return true;
+            }
+        }
+    }
+
+    // start over from where the hunter is
+    stats.restarts++;
+    restart(map, here, target);
+    if (!computeShortestPath(map) || !extractRoute())
+        return false;
+    output(0);
+    return true;
+}
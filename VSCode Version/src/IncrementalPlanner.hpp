@@ -0,0 +1,90 @@
+#pragma once
+#include <raylib.h>
+#include <climits>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+class Tilemap;
+
+/*
+D* Lite for one hunter that keeps chasing a moving goal. The search is rooted at the tile
+the hunter stood on when it started, and the goal plays the part D* Lite normally gives the
+moving robot: when it moves the keys are shifted by km instead of starting over. Tiles the
+map carved open since last time (Tilemap::openedSince) are fed in as cheaper edges, and
+only the part of the search they affect gets redone.
+
+The hunter walks along the returned path, so while it's still on the new path the suffix
+from its tile is already the shortest. It starts over from where the hunter is when it has
+wandered off the path, got too far from the root, or the map changed too much to replay.
+Same moves and costs as Pathfinder (8 way, 10/14, no corner cutting), paths are shortest.
+
+A plan can be given a budget of queue pops (expansions plus the stale entries a moved goal
+leaves behind, which cost about the same). When it runs out the search is kept as it is and
+plan() returns false with lastOutOfBudget() set, the next call picks up where it stopped, so
+a big repair gets spread over a few ticks while the hunter walks its old path.
+
+State lives in a hash map keyed by tile so an idle planner costs next to nothing.
+*/
+class IncrementalPlanner
+{
+public:
+    static const int REROOT_TILES = 24;     // start over once the hunter is this far from the root
+    static const int MAX_EXPANSIONS = 20000; // default budget in queue pops, like ChunkWorld
+
+    struct Stats
+    {
+        long plans = 0;
+        long repairs = 0;  // reused the last search
+        long restarts = 0; // had to start over
+    };
+
+    // tile path from 'from' to 'goal', start excluded like Pathfinder. false if there's none or
+    // the budget ran out first (see lastOutOfBudget)
+    bool plan(const Tilemap &map, Vector2 from, Vector2 goal, std::vector<Vector2> &outPath,
+              int budget = MAX_EXPANSIONS);
+    void reset(); // forget the search (stats stay)
+
+    int lastExpanded() const { return expanded; }
+    bool lastWasRepair() const { return repaired; }
+    bool lastOutOfBudget() const { return outOfBudget; }
+    const Stats &getStats() const { return stats; }
+    size_t memoryBytes() const;
+
+private:
+    static const int INF = INT_MAX / 2;
+
+    struct Cell
+    {
+        int g = INF, rhs = INF;
+        int parent = -1; // the neighbour rhs came through
+    };
+    struct Item
+    {
+        int k1, k2, index;
+        bool operator>(const Item &o) const { return k1 != o.k1 ? k1 > o.k1 : (k2 != o.k2 ? k2 > o.k2 : index > o.index); }
+    };
+
+    bool active = false;
+    int width = 0, height = 0;
+    int root = -1, goal = -1;
+    int km = 0;
+    unsigned editVersion = 0;
+    std::unordered_map<int, Cell> cells;
+    std::vector<Item> open; // heap, may hold stale entries
+    std::vector<int> opened, route;
+    int expanded = 0;
+    int popped = 0; // this plan, checked against budget
+    int budget = MAX_EXPANSIONS;
+    bool repaired = false;
+    bool outOfBudget = false;
+    Stats stats;
+
+    void restart(const Tilemap &map, int rootIndex, int goalIndex);
+    Cell get(int i) const;
+    int heuristic(int i) const;
+    Item keyOf(int i, const Cell &c) const;
+    void updateVertex(const Tilemap &map, int i);
+    bool computeShortestPath(const Tilemap &map);
+    bool extractRoute();
+};
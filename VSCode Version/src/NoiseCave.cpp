@@ -0,0 +1,77 @@
+#include "NoiseCave.hpp"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// raylib builds its own copy of stb_perlin into rtextures (only with image generation on),
+// so compile a private one under different names instead of relying on that
+#define stb_perlin_noise3 emerge_perlin_noise3
+#define stb_perlin_noise3_seed emerge_perlin_noise3_seed
+#define stb_perlin_ridge_noise3 emerge_perlin_ridge_noise3
+#define stb_perlin_fbm_noise3 emerge_perlin_fbm_noise3
+#define stb_perlin_turbulence_noise3 emerge_perlin_turbulence_noise3
+#define stb_perlin_noise3_wrap_nonpow2 emerge_perlin_noise3_wrap_nonpow2
+#define stb_perlin_noise3_internal emerge_perlin_noise3_internal
+#define STB_PERLIN_IMPLEMENTATION
+#include <external/stb_perlin.h>
+
+// stb_perlin only takes an 8 bit seed, the rest of it picks a z slice so seeds don't repeat
+static inline float seedSlice(unsigned seed) { return (float)(seed >> 8) * 1.618034f; }
+
+bool noiseCaveWall(unsigned seed, const NoiseCaveParams &p, int x, int y)
+{
+    const int s = (int)(seed & 255u);
+    const float z = seedSlice(seed);
+
+    // domain warp, two independent noise lookups shift the sample point
+    float wx = x * p.warpFrequency, wy = y * p.warpFrequency;
+    float sx = x + p.warp * emerge_perlin_noise3_seed(wx, wy, z + 11.5f, 0, 0, 0, s);
+    float sy = y + p.warp * emerge_perlin_noise3_seed(wx + 37.2f, wy - 19.7f, z + 23.5f, 0, 0, 0, s);
+
+    // fractal sum, normalised back to about -1..1
+    float freq = p.frequency, amp = 1.0f, sum = 0.0f, norm = 0.0f;
+    for (int o = 0; o < p.octaves; ++o)
+    {
+        sum += amp * emerge_perlin_noise3_seed(sx * freq, sy * freq, z + o * 7.3f, 0, 0, 0, s);
+        norm += amp;
+        freq *= p.lacunarity;
+        amp *= p.gain;
+    }
+    return sum / norm > p.threshold;
+}
+
+static void fillRows(unsigned seed, const NoiseCaveParams &p, int x0, int y0, int w, uint8_t *out, int r0, int r1)
+{
+    for (int r = r0; r < r1; ++r)
+    {
+        uint8_t *row = out + (size_t)r * w;
+        for (int c = 0; c < w; ++c)
+            row[c] = noiseCaveWall(seed, p, x0 + c, y0 + r) ? 1 : 0;
+    }
+}
+
+void fillNoiseCave(unsigned seed, const NoiseCaveParams &p, int x0, int y0, int w, int h, uint8_t *out, int threads)
+{
+    if (threads <= 0)
+        threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    // each row is a few thousand noise lookups, 16 rows a thread is plenty
+    threads = std::min(threads, std::max(1, h / 16));
+
+    if (threads == 1)
+    {
+        fillRows(seed, p, x0, y0, w, out, 0, h);
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    int band = (h + threads - 1) / threads;
+    for (int t = 0; t < threads; ++t)
+    {
+        int r0 = t * band, r1 = std::min(h, r0 + band);
+        if (r0 >= r1)
+            break;
+        pool.emplace_back(fillRows, seed, std::cref(p), x0, y0, w, out, r0, r1);
+    }
+    for (auto &th : pool)
+        th.join();
+}
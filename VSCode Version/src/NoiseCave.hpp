@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+
+// knobs for the noise cave, distances are in tiles
+struct NoiseCaveParams
+{
+    float frequency = 0.07f; // base noise frequency, bigger = smaller caverns
+    int octaves = 4;
+    float lacunarity = 2.0f; // frequency multiplier per octave
+    float gain = 0.5f;       // amplitude multiplier per octave
+    float warp = 6.0f;       // how far the domain warp pushes sample points
+    float warpFrequency = 0.04f;
+    float threshold = 0.02f; // noise above this is wall
+};
+
+/*
+Cave generator built on fractal perlin noise (raylib's vendored stb_perlin).
+Every tile is a pure function of (seed, x, y): the sample point is pushed around by a
+low frequency warp field, then a few octaves of noise are summed and thresholded.
+No neighbour passes, so any rectangle of the world can be made on its own, in any order
+and on any thread, and it lines up with its neighbours.
+*/
+bool noiseCaveWall(unsigned seed, const NoiseCaveParams &p, int x, int y);
+
+// fills a w*h block whose top left tile is (x0, y0), one byte per tile, 1 = wall.
+// rows are split over threads (0 = hardware threads)
+void fillNoiseCave(unsigned seed, const NoiseCaveParams &p, int x0, int y0, int w, int h, uint8_t *out, int threads = 1);
@@ -0,0 +1,95 @@
+#include "PathScheduler.hpp"
+#include "Pathfinder.hpp"
+#include "Tilemap.hpp"
+#include <algorithm>
+
+void PathScheduler::setBudget(float msPerTick, int nodesPerTick)
+{
+    budgetMs = msPerTick;
+    budgetNodes = nodesPerTick;
+}
+
+void PathScheduler::request(int hunterId, Vector2 start, Vector2 goal, Priority priority)
+{
+    if (pending.count(hunterId))
+        stats.replaced++;
+
+    Pending p{nextSeq++, start, goal, priority, Clock::now(), tick};
+    pending[hunterId] = p;
+    queue.push({(int)priority, p.seq, hunterId});
+
+    stats.queueDepth = (int)pending.size();
+    stats.maxQueueDepth = std::max(stats.maxQueueDepth, stats.queueDepth);
+}
+
+void PathScheduler::cancel(int hunterId)
+{
+    pending.erase(hunterId);
+    results.erase(hunterId);
+    stats.queueDepth = (int)pending.size();
+}
+
+void PathScheduler::clear()
+{
+    queue = {};
+    pending.clear();
+    results.clear();
+    latencySumMs = 0.0;
+    stats = {};
+}
+
+void PathScheduler::update(const Tilemap &world)
+{
+    tick++;
+    Clock::time_point start = Clock::now();
+    Pathfinder &pf = Pathfinder::forThread();
+
+    int searches = 0, nodes = 0;
+    double spentMs = 0.0;
+    while (!queue.empty())
+    {
+        // always make some progress, after that stop once the budget is gone
+        if (searches > 0 && (spentMs >= budgetMs || nodes >= budgetNodes))
+            break;
+
+        Entry e = queue.top();
+        queue.pop();
+        auto it = pending.find(e.hunterId);
+        if (it == pending.end() || it->second.seq != e.seq)
+            continue; // cancelled or replaced
+
+        Pending req = it->second;
+        pending.erase(it);
+
+        // no route means no result, the hunter just keeps its old path
+        if (pf.findPath(world, req.start, req.goal, scratch))
+            results[e.hunterId].swap(scratch);
+        searches++;
+        nodes += pf.lastExpanded();
+
+        Clock::time_point now = Clock::now();
+        spentMs = std::chrono::duration<double, std::milli>(now - start).count();
+
+        double latency = std::chrono::duration<double, std::milli>(now - req.submitted).count();
+        stats.completed++;
+        latencySumMs += latency;
+        stats.avgLatencyMs = latencySumMs / stats.completed;
+        stats.maxLatencyMs = std::max(stats.maxLatencyMs, latency);
+        stats.maxLatencyTicks = std::max(stats.maxLatencyTicks, tick - req.submittedTick);
+    }
+
+    stats.queueDepth = (int)pending.size();
+    stats.searchesLastTick = searches;
+    stats.nodesLastTick = nodes;
+    stats.msLastTick = spentMs;
+}
+
+bool PathScheduler::takeResult(int hunterId, std::vector<Vector2> &outPath)
+{
+    auto it = results.find(hunterId);
+    if (it == results.end())
+        return false;
+    outPath.swap(it->second);
+    results.erase(it);
+    return true;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <raylib.h>
+#include <chrono>
+#include <cstdint>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+class Tilemap;
+
+/*
+Queue of path requests so hunters don't all run A* on the same frame.
+Hunters submit a request with their id and a priority, update() runs searches
+(highest priority first, oldest first within a priority) until the frame's budget
+is spent, and the hunter picks the path up on a later tick. Until then it keeps
+following whatever path it already had.
+
+A hunter only ever has one request waiting, a newer one replaces it.
+Searches run whole, the budget is checked between them, and at least one runs
+every update so the queue can't stall.
+*/
+class PathScheduler
+{
+public:
+    enum class Priority
+    {
+        Patrol = 0,
+        Search = 1,
+        Chase = 2
+    };
+
+    struct Stats
+    {
+        int queueDepth = 0;        // requests waiting right now
+        int maxQueueDepth = 0;     // worst seen since the last reset
+        int searchesLastTick = 0;  // how many ran in the last update
+        int nodesLastTick = 0;     // A* expansions in the last update
+        double msLastTick = 0.0;   // time spent in the last update
+        long completed = 0;        // searches run
+        long replaced = 0;         // requests dropped for a newer one from the same hunter
+        double avgLatencyMs = 0.0; // submit -> result ready
+        double maxLatencyMs = 0.0;
+        int maxLatencyTicks = 0;
+    };
+
+    // per update, a search is started while both are under budget
+    void setBudget(float msPerTick, int nodesPerTick);
+
+    void request(int hunterId, Vector2 start, Vector2 goal, Priority priority);
+    void cancel(int hunterId); // drops the request and any unclaimed result
+    void clear();              // new world, forget everything (stats too)
+
+    void update(const Tilemap &world);
+
+    // true once when a new path is waiting for this hunter (searches that find no route give nothing)
+    bool takeResult(int hunterId, std::vector<Vector2> &outPath);
+
+    const Stats &getStats() const { return stats; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Pending
+    {
+        uint64_t seq;
+        Vector2 start, goal;
+        Priority priority;
+        Clock::time_point submitted;
+        int submittedTick;
+    };
+    struct Entry
+    {
+        int priority;
+        uint64_t seq;
+        int hunterId;
+        bool operator<(const Entry &o) const
+        {
+            // std::priority_queue pops the largest, so higher priority then older first
+            return priority != o.priority ? priority < o.priority : seq > o.seq;
+        }
+    };
+
+    float budgetMs = 1.0f;
+    int budgetNodes = 20000;
+
+    uint64_t nextSeq = 0;
+    int tick = 0;
+    std::priority_queue<Entry> queue; // may hold stale entries, checked against pending
+    std::unordered_map<int, Pending> pending;
+    std::unordered_map<int, std::vector<Vector2>> results;
+    std::vector<Vector2> scratch;
+    double latencySumMs = 0.0;
+    Stats stats;
+};
@@ -0,0 +1,386 @@
+#include "Pathfinder.hpp"
+#include "Tilemap.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+static const int DIR8[8][2] = {
+    {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1}};
+
+// DIR8 index for a step of (dx, dy), looked up as [dy + 1][dx + 1]
+static const int DIR_INDEX[3][3] = {{7, 3, 6}, {1, -1, 0}, {5, 2, 4}};
+
+// octile distance, exact on an open grid with 10/14 steps so it never overestimates
+static int octile(int x0, int y0, int x1, int y1)
+{
+    int dx = abs(x1 - x0), dy = abs(y1 - y0);
+    return 10 * std::max(dx, dy) + 4 * std::min(dx, dy);
+}
+
+// closest tile to (gx, gy) in the given region, looking out ring by ring up to maxTiles
+static bool nearestInRegion(const FloorComponents &regions, int region, int maxTiles, int &gx, int &gy)
+{
+    int bestD2 = maxTiles * maxTiles + 1, bx = 0, by = 0;
+    for (int r = 1; r <= maxTiles && r * r < bestD2; ++r)
+    {
+        for (int dy = -r; dy <= r; ++dy)
+        {
+            // whole rows at the top and bottom, just the two ends in between
+            int step = (dy == -r || dy == r) ? 1 : 2 * r;
+            for (int dx = -r; dx <= r; dx += step)
+            {
+                int d2 = dx * dx + dy * dy;
+                if (d2 < bestD2 && regions.at(gx + dx, gy + dy) == region)
+                {
+                    bestD2 = d2;
+                    bx = gx + dx;
+                    by = gy + dy;
+                }
+            }
+        }
+    }
+    if (bestD2 > maxTiles * maxTiles)
+        return false;
+    gx = bx;
+    gy = by;
+    return true;
+}
+
+Pathfinder &Pathfinder::forThread()
+{
+    thread_local Pathfinder pf;
+    return pf;
+}
+
+size_t Pathfinder::memoryBytes() const
+{
+    return visit.capacity() * sizeof(uint32_t) + g.capacity() * sizeof(int) + dir.capacity() +
+           heap.capacity() * sizeof(Node) + buckets.memoryBytes();
+}
+
+void Pathfinder::prepare(size_t tileCount)
+{
+    // follows the size of whatever map it was last used on
+    if (visit.size() != tileCount)
+    {
+        visit.assign(tileCount, 0);
+        g.assign(tileCount, 0);
+        dir.assign(tileCount, 0);
+        stamp = 0;
+    }
+    if (stamp >= 0x7FFFFFFEu)
+    {
+        // stamp about to wrap, clear once
+        std::fill(visit.begin(), visit.end(), 0);
+        stamp = 0;
+    }
+    stamp++;
+    heap.clear();
+    buckets.clear();
+}
+
+// open list, keeps its capacity between queries either way
+void Pathfinder::pushOpen(const Node &n)
+{
+    if (openList == OpenList::Buckets)
+    {
+        buckets.push(n.f, n);
+        return;
+    }
+    heap.push_back(n);
+    std::push_heap(heap.begin(), heap.end(), [](const Node &a, const Node &b)
+                   { return a.f > b.f; });
+}
+
+// node with the smallest f
+Pathfinder::Node Pathfinder::popOpen()
+{
+    if (openList == OpenList::Buckets)
+    {
+        int f;
+        return buckets.pop(f);
+    }
+    std::pop_heap(heap.begin(), heap.end(), [](const Node &a, const Node &b)
+                  { return a.f > b.f; });
+    Node q = heap.back();
+    heap.pop_back();
+    return q;
+}
+
+bool Pathfinder::findPath(const Tilemap &map, Vector2 startWorld, Vector2 goalWorld, std::vector<Vector2> &outPath)
+{
+    // simple grid pathfinding using map tiles
+
+    // convert world coordinates to tile grid coordinates
+    expanded = 0;
+    redirected = false;
+    int sx, sy, gx, gy;
+    map.worldToTile(startWorld, sx, sy);
+    map.worldToTile(goalWorld, gx, gy);
+    const int W = map.getWidth(), H = map.getHeight();
+    // dont path from outside the map
+    if (sx < 0 || sy < 0 || sx >= W || sy >= H)
+        return false;
+
+    // a goal in a wall or in another region can't be reached, find that out without searching.
+    // a start shoved into a wall has no region, the search decides then
+    const FloorComponents &regions = map.getComponents();
+    const int startRegion = regions.at(sx, sy);
+    if (startRegion >= 0 && regions.at(gx, gy) != startRegion)
+    {
+        if (!nearestInRegion(regions, startRegion, redirectTiles, gx, gy))
+            return false;
+        redirected = true;
+    }
+    else if (map.isWall(gx, gy))
+        return false;
+
+    // long trips go over the cluster graph, that only looks at clusters along the way
+    // (asking for the graph builds it, so short trips don't)
+    if (useClusters && std::max(abs(gx - sx), abs(gy - sy)) >= ClusterGraph::LONG_QUERY_TILES)
+    {
+        const ClusterGraph &clusters = map.getClusterGraph();
+        if (clusters.ready())
+            return clusters.findPath(map, sx, sy, gx, gy, outPath, clusterSearch, expanded);
+    }
+
+    prepare((size_t)W * H);
+    if (mode == Mode::JumpPoint)
+        return searchJump(map, sx, sy, gx, gy, outPath);
+    return searchAStar(map, sx, sy, gx, gy, outPath);
+}
+
+bool Pathfinder::searchAStar(const Tilemap &map, int sx, int sy, int gx, int gy, std::vector<Vector2> &outPath)
+{
+    const int W = map.getWidth(), H = map.getHeight();
+    const uint32_t OPEN = stamp * 2, CLOSED = stamp * 2 + 1;
+    const uint8_t *tiles = map.data();
+    auto idx = [&](int x, int y)
+    { return (size_t)y * W + x; };
+
+    // octile rather than manhattan, manhattan overestimates diagonals so paths could come out longer than needed
+    auto Hcost = [&](int x, int y)
+    { return octile(x, y, gx, gy); };
+
+    visit[idx(sx, sy)] = OPEN;
+    g[idx(sx, sy)] = 0;
+    pushOpen({sx, sy, Hcost(sx, sy)});
+
+    // pathfinding loop
+    while (!openEmpty())
+    {
+        Node cur = popOpen(); // node with lowest f
+        int x = cur.x, y = cur.y;
+        size_t ci = idx(x, y);
+        if (visit[ci] == CLOSED)
+            continue;
+        visit[ci] = CLOSED; // mark as visited
+        expanded++;
+
+        // goal check
+        if (x == gx && y == gy)
+        {
+            // rebuild path by backtracking
+            outPath.clear();
+            while (!(x == sx && y == sy))
+            {
+                outPath.push_back(map.tileToWorldCenter(x, y));
+                int d = dir[idx(x, y)];
+                x -= DIR8[d][0];
+                y -= DIR8[d][1];
+            }
+            std::reverse(outPath.begin(), outPath.end());
+            return true; // success
+        }
+
+        // explore neighbours in eight directions
+        for (int i = 0; i < 8; ++i)
+        {
+            int nx = x + DIR8[i][0], ny = y + DIR8[i][1];
+
+            // skip out of bounds
+            if (nx < 0 || ny < 0 || nx >= W || ny >= H)
+                continue;
+            // skip walls
+            if (tiles[idx(nx, ny)])
+                continue;
+
+            bool diagonal = (DIR8[i][0] != 0 && DIR8[i][1] != 0);
+            if (diagonal)
+            {
+                // both sides have to be open, no corner cutting
+                if (tiles[idx(x + DIR8[i][0], y)] || tiles[idx(x, y + DIR8[i][1])])
+                    continue;
+            }
+
+            // skip closed tiles
+            size_t ni = idx(nx, ny);
+            if (visit[ni] == CLOSED)
+                continue;
+
+            // cost to move to neighbour
+            int stepCost = diagonal ? 14 : 10;
+            int cost = g[ci] + stepCost;
+
+            // update if neighbours not open or cheaper path found
+            if (visit[ni] != OPEN || cost < g[ni])
+            {
+                visit[ni] = OPEN;
+                g[ni] = cost;
+                dir[ni] = (uint8_t)i;
+                pushOpen({nx, ny, cost + Hcost(nx, ny)});
+            }
+        }
+    }
+    // edge case, no path is found
+    return false;
+}
+
+bool Pathfinder::searchJump(const Tilemap &map, int sx, int sy, int gx, int gy, std::vector<Vector2> &outPath)
+{
+    const int W = map.getWidth(), H = map.getHeight();
+    const uint32_t OPEN = stamp * 2, CLOSED = stamp * 2 + 1;
+    const uint8_t *tiles = map.data();
+    auto idx = [&](int x, int y)
+    { return (size_t)y * W + x; };
+    auto open = [&](int x, int y)
+    { return (unsigned)x < (unsigned)W && (unsigned)y < (unsigned)H && !tiles[idx(x, y)]; };
+
+    // a straight run stops on a tile with a wall just behind it on one side and open
+    // ground beside it, that's where turning the corner is cheaper than any other way round
+    auto forcedStraight = [&](int x, int y, int dx, int dy)
+    {
+        if (dx != 0)
+            return (open(x, y - 1) && !open(x - dx, y - 1)) || (open(x, y + 1) && !open(x - dx, y + 1));
+        return (open(x - 1, y) && !open(x - 1, y - dy)) || (open(x + 1, y) && !open(x + 1, y - dy));
+    };
+
+    // walk from (x, y) in a straight line until a jump point, the goal, or a wall
+    auto jumpStraight = [&](int x, int y, int dx, int dy, int &jx, int &jy)
+    {
+        for (;;)
+        {
+            x += dx;
+            y += dy;
+            if (!open(x, y))
+                return false;
+            if ((x == gx && y == gy) || forcedStraight(x, y, dx, dy))
+            {
+                jx = x;
+                jy = y;
+                return true;
+            }
+        }
+    };
+
+    // diagonals never force anything without corner cutting, a diagonal tile is a jump
+    // point when one of its two straight runs finds something
+    auto jumpDiagonal = [&](int x, int y, int dx, int dy, int &jx, int &jy)
+    {
+        int tx, ty;
+        for (;;)
+        {
+            if (!open(x + dx, y) || !open(x, y + dy))
+                return false;
+            x += dx;
+            y += dy;
+            if (!open(x, y))
+                return false;
+            if ((x == gx && y == gy) || jumpStraight(x, y, dx, 0, tx, ty) || jumpStraight(x, y, 0, dy, tx, ty))
+            {
+                jx = x;
+                jy = y;
+                return true;
+            }
+        }
+    };
+
+    visit[idx(sx, sy)] = OPEN;
+    g[idx(sx, sy)] = 0;
+    pushOpen({sx, sy, octile(sx, sy, gx, gy)});
+
+    while (!openEmpty())
+    {
+        Node cur = popOpen();
+        int x = cur.x, y = cur.y;
+        size_t ci = idx(x, y);
+        if (visit[ci] == CLOSED)
+            continue;
+        visit[ci] = CLOSED;
+        expanded++;
+
+        if (x == gx && y == gy)
+        {
+            // jump points only know the direction they came from, so step back one tile at a
+            // time counting the cost down, and take the next direction on a closed tile whose
+            // cost matches (another jump point on the same line can have a different parent)
+            outPath.clear();
+            int d = dir[ci], left = g[ci];
+            while (!(x == sx && y == sy))
+            {
+                outPath.push_back(map.tileToWorldCenter(x, y));
+                left -= (d >= 4) ? 14 : 10;
+                x -= DIR8[d][0];
+                y -= DIR8[d][1];
+                size_t pi = idx(x, y);
+                if (visit[pi] == CLOSED && g[pi] == left)
+                    d = dir[pi];
+            }
+            std::reverse(outPath.begin(), outPath.end());
+            return true;
+        }
+
+        // which directions are worth trying from here, one bit per DIR8 entry
+        unsigned dirs = 0;
+        if (x == sx && y == sy)
+            dirs = 0xFF;
+        else
+        {
+            int pdx = DIR8[dir[ci]][0], pdy = DIR8[dir[ci]][1];
+            if (pdx != 0 && pdy != 0)
+            {
+                dirs |= 1u << DIR_INDEX[1][pdx + 1];
+                dirs |= 1u << DIR_INDEX[pdy + 1][1];
+                dirs |= 1u << DIR_INDEX[pdy + 1][pdx + 1];
+            }
+            else if (pdx != 0)
+            {
+                dirs |= 1u << DIR_INDEX[1][pdx + 1];
+                for (int side = -1; side <= 1; side += 2)
+                    if (open(x, y + side) && !open(x - pdx, y + side))
+                        dirs |= (1u << DIR_INDEX[side + 1][1]) | (1u << DIR_INDEX[side + 1][pdx + 1]);
+            }
+            else
+            {
+                dirs |= 1u << DIR_INDEX[pdy + 1][1];
+                for (int side = -1; side <= 1; side += 2)
+                    if (open(x + side, y) && !open(x + side, y - pdy))
+                        dirs |= (1u << DIR_INDEX[1][side + 1]) | (1u << DIR_INDEX[pdy + 1][side + 1]);
+            }
+        }
+
+        for (int i = 0; i < 8; ++i)
+        {
+            if (!(dirs & (1u << i)))
+                continue;
+            int dx = DIR8[i][0], dy = DIR8[i][1];
+            int jx, jy;
+            bool found = (dx != 0 && dy != 0) ? jumpDiagonal(x, y, dx, dy, jx, jy) : jumpStraight(x, y, dx, dy, jx, jy);
+            if (!found)
+                continue;
+
+            size_t ni = idx(jx, jy);
+            if (visit[ni] == CLOSED)
+                continue;
+            // jump points sit on a straight or diagonal line from here
+            int cost = g[ci] + octile(x, y, jx, jy);
+            if (visit[ni] != OPEN || cost < g[ni])
+            {
+                visit[ni] = OPEN;
+                g[ni] = cost;
+                dir[ni] = (uint8_t)i;
+                pushOpen({jx, jy, cost + octile(jx, jy, gx, gy)});
+            }
+        }
+    }
+    return false;
+}
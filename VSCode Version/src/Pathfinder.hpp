@@ -0,0 +1,95 @@
+#pragma once
+#include <raylib.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "ClusterGraph.hpp"
+#include "BucketQueue.hpp"
+
+class Tilemap;
+
+/*
+A* over a Tilemap with its own search scratch, sized to the map on first use and reused.
+A tile is open when visit == 2*stamp and closed when visit == 2*stamp+1, so nothing is
+cleared between queries.
+
+JumpPoint mode runs Jump Point Search instead: same moves and costs (8 way, 10/14, no
+corner cutting) so the path costs the same as A*, but straight and diagonal runs are
+scanned without pushing every tile, which saves most of the work in open caverns.
+Both return every tile along the way so callers can't tell them apart.
+
+Goals the start can't reach (a wall, or floor in another region of the map's
+FloorComponents) fail straight away, or get moved to the closest reachable tile within
+the redirect radius, instead of flooding the whole cave to find out.
+
+The open list is a BucketQueue by default: f only goes up (octile is consistent, for jump
+points too) and is a small integer, so there's no log factor and no allocation once it has
+grown. The binary heap it replaced is still there to compare against.
+
+Trips longer than ClusterGraph::LONG_QUERY_TILES go over the map's cluster graph instead
+(unless turned off), which is much cheaper on big maps but only close to the shortest path.
+
+The map is only read, so any number of Pathfinders can search the same const Tilemap at
+once. One Pathfinder must not be used by two threads at the same time, forThread() hands
+each thread its own.
+*/
+class Pathfinder
+{
+public:
+    enum class Mode
+    {
+        AStar,
+        JumpPoint
+    };
+
+    enum class OpenList
+    {
+        BinaryHeap,
+        Buckets
+    };
+
+    void setMode(Mode m) { mode = m; }
+    Mode getMode() const { return mode; }
+    void setOpenList(OpenList o) { openList = o; }
+    void setUseClusters(bool on) { useClusters = on; }
+
+    static const int DEFAULT_REDIRECT_TILES = 6;
+    // how far an unreachable goal may be moved, 0 = just fail
+    void setRedirectTiles(int tiles) { redirectTiles = tiles; }
+
+    bool findPath(const Tilemap &map, Vector2 startWorld, Vector2 goalWorld, std::vector<Vector2> &outPath);
+    int lastExpanded() const { return expanded; } // nodes closed by the last search (jump points for JPS, graph nodes and cluster tiles for long trips)
+    bool lastRedirected() const { return redirected; } // the last path ends near the goal, not on it
+
+    // the calling thread's pathfinder, made on first use and kept until the thread exits
+    static Pathfinder &forThread();
+
+    size_t memoryBytes() const;
+
+private:
+    struct Node
+    {
+        int x, y, f;
+    };
+
+    std::vector<uint32_t> visit;
+    std::vector<int> g;
+    std::vector<uint8_t> dir; // direction index we arrived from
+    std::vector<Node> heap;
+    BucketQueue<Node> buckets;
+    uint32_t stamp = 0;
+    int expanded = 0;
+    Mode mode = Mode::JumpPoint;
+    OpenList openList = OpenList::Buckets;
+    bool useClusters = true;
+    int redirectTiles = DEFAULT_REDIRECT_TILES;
+    bool redirected = false;
+    ClusterGraph::Search clusterSearch;
+
+    void prepare(size_t tileCount);
+    void pushOpen(const Node &n);
+    Node popOpen();
+    bool openEmpty() const { return openList == OpenList::Buckets ? buckets.empty() : heap.empty(); }
+    bool searchAStar(const Tilemap &map, int sx, int sy, int gx, int gy, std::vector<Vector2> &outPath);
+    bool searchJump(const Tilemap &map, int sx, int sy, int gx, int gy, std::vector<Vector2> &outPath);
+};
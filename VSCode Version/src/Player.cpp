@@ -1,6 +1,7 @@
 #include "Player.hpp"
 #include "Tilemap.hpp"
 #include "Hunter.hpp"
+#include "SpatialHash.hpp"
 #include <cmath>
 
 Player::Player(Vector2 startPos) : pos(startPos)
@@ -8,7 +9,8 @@ Player::Player(Vector2 startPos) : pos(startPos)
     applyStageVisuals();
 }
 
-void Player::update(float dt, Tilemap &world, const Camera2D &cam, std::vector<Animal> &animals, std::vector<Hunter> &hunters)
+void Player::update(float dt, Tilemap &world, const Camera2D &cam, std::vector<Animal> &animals, std::vector<Hunter> &hunters,
+                    const SpatialHash &animalHash, const SpatialHash &hunterHash)
 {
     // cooldown timers
     if (biteTimer > 0.0f)
@@ -70,6 +72,7 @@ void Player::update(float dt, Tilemap &world, const Camera2D &cam, std::vector<A
             stage = (stage < 4) ? stage + 1 : 4;
 
             applyStageVisuals();
+            growInto(world);
 
             // when reahing stage 2 reveal new ability
             if (stage == 2)
@@ -152,25 +155,13 @@ void Player::update(float dt, Tilemap &world, const Camera2D &cam, std::vector<A
                 slamImpactPos = pos;
                 slamJustFired = true;
 
-                for (auto &a : animals)
-                {
-                    if (!a.alive)
-                        continue;
-                    float dx = a.pos.x - pos.x, dy = a.pos.y - pos.y;
-                    float rr = (slamRadius + a.radius + slamKillPad);
-                    if (dx * dx + dy * dy <= rr * rr)
-                        a.alive = false;
-                }
-
-                for (auto &h : hunters)
-                {
-                    float dx = h.pos.x - pos.x, dy = h.pos.y - pos.y;
-                    float rr = (slamRadius + h.radius + slamKillPad);
-                    if (dx * dx + dy * dy <= rr * rr)
-                    {
-                        h.applyHit(slamDamage(), pos, 300.0f);
-                    }
-                }
+                animalHash.circle(pos, slamRadius + slamKillPad, [&](int i)
+                                  { animals[i].alive = false; });
+
+                hunterHash.circle(pos, slamRadius + slamKillPad, [&](int i)
+                                  {
+                    if (hunters[i].isAlive())
+                        hunters[i].applyHit(slamDamage(), pos, 300.0f); });
 
                 // break walls (except outer border)
                 world.carveCircle(pos, slamRadius, true);
@@ -188,29 +179,19 @@ void Player::update(float dt, Tilemap &world, const Camera2D &cam, std::vector<A
         delta = {dashDir.x * dashSpeed * dt, dashDir.y * dashSpeed * dt};
         world.resolveCollision(pos, radius, delta);
 
-        for (auto &a : animals)
-        {
-            if (!a.alive)
-                continue;
-            float dx = a.pos.x - pos.x, dy = a.pos.y - pos.y;
-            float rr = (radius + a.radius + dashKillPad);
-            // is monster overlaps animals during dash
-            if (dx * dx + dy * dy <= rr * rr)
+        // is monster overlaps animals during dash
+        animalHash.circle(pos, radius + dashKillPad, [&](int i)
+                          {
+            if (animals[i].alive)
             {
-                a.alive = false;
+                animals[i].alive = false;
                 food += 1;
-            }
-        }
+            } });
 
-        for (auto &h : hunters)
-        {
-            float dx = h.pos.x - pos.x, dy = h.pos.y - pos.y;
-            float rr = (radius + h.radius + dashKillPad);
-            if (dx * dx + dy * dy <= rr * rr)
-            {
-                h.applyHit(dashDamage(), pos, 240.0f);
-            }
-        }
+        hunterHash.circle(pos, radius + dashKillPad, [&](int i)
+                          {
+            if (hunters[i].isAlive())
+                hunters[i].applyHit(dashDamage(), pos, 240.0f); });
 
         dashElapsed += dt;
         // starts cooldown when dash ends
@@ -323,10 +304,8 @@ void Player::draw() const
     }
 }
 
-static inline float dot(Vector2 a, Vector2 b) { return a.x * b.x + a.y * b.y; }
-static inline float len(Vector2 v) { return sqrtf(v.x * v.x + v.y * v.y); }
-
-int Player::tryBite(std::vector<Animal> &animals, std::vector<Hunter> &hunters)
+int Player::tryBite(std::vector<Animal> &animals, std::vector<Hunter> &hunters, const SpatialHash &animalHash,
+                    const SpatialHash &hunterHash)
 {
     if (!IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
         return 0;
@@ -345,39 +324,18 @@ int Player::tryBite(std::vector<Animal> &animals, std::vector<Hunter> &hunters)
     float cosHalfArc = cosf((biteArcDeg * 0.5f) * (PI / 180.0f));
 
     int eaten = 0;
-    for (auto &a : animals)
-    {
-        if (!a.alive)
-            continue;
-        Vector2 to = {a.pos.x - pos.x, a.pos.y - pos.y};
-        float d = len(to);
-        if (d > (biteRange + a.radius))
-            continue;
-
-        // angle check
-        Vector2 n = d > 0.0001f ? Vector2{to.x / d, to.y / d} : Vector2{0, 0};
-        float facing = dot(fwd, n);
-        if (facing >= cosHalfArc)
+    animalHash.sector(pos, biteRange, fwd, cosHalfArc, [&](int i)
+                      {
+        if (animals[i].alive)
         {
-            a.alive = false;
+            animals[i].alive = false;
             eaten++;
-        }
-    }
+        } });
 
-    for (auto &h : hunters)
-    {
-        Vector2 to = {h.pos.x - pos.x, h.pos.y - pos.y};
-        float d = sqrtf(to.x * to.x + to.y * to.y);
-        if (d > (biteRange + h.radius))
-            continue;
-        Vector2 n = (d > 0.0001f) ? Vector2{to.x / d, to.y / d} : Vector2{0, 0};
-        Vector2 fwd = {cosf(angle), sinf(angle)};
-        float cosHalfArc = cosf((biteArcDeg * 0.5f) * (PI / 180.0f));
-        if (fwd.x * n.x + fwd.y * n.y >= cosHalfArc)
-        {
-            h.applyHit(biteDamage(), pos, 180.0f);
-        }
-    }
+    hunterHash.sector(pos, biteRange, fwd, cosHalfArc, [&](int i)
+                      {
+        if (hunters[i].isAlive())
+            hunters[i].applyHit(biteDamage(), pos, 180.0f); });
 
     if (eaten > 0)
     {
@@ -442,6 +400,19 @@ bool Player::tryFireBoulder(std::vector<Boulder> &pool, const Camera2D &cam)
     return false;
 };
 
+void Player::growInto(Tilemap &world)
+{
+    // collides at full size, so from stage 2 (36px across) one tile corridors are too tight
+    if (!world.circleHitsWall(pos, radius))
+        return;
+    // the outer border stays, step a pixel clear of it first. the carve goes by tile centres,
+    // a tile past the body catches the ones only poking a corner in
+    const float T = (float)Tilemap::TILE_SIZE, m = radius + 1.0f;
+    pos.x = fminf(fmaxf(pos.x, T + m), (world.getWidth() - 1) * T - m);
+    pos.y = fminf(fmaxf(pos.y, T + m), (world.getHeight() - 1) * T - m);
+    world.carveCircle(pos, radius + T, true);
+}
+
 void Player::applyStageVisuals()
 {
     int idx = (stage <= 1) ? 0 : (stage == 2 ? 1 : (stage == 3 ? 2 : 3));
@@ -6,12 +6,15 @@
 #include "Boulder.hpp"
 
 class Hunter;
+class SpatialHash;
 
 class Player
 {
 public:
     Player(Vector2 startPos);
-    void update(float dt, Tilemap &world, const Camera2D &cam, std::vector<Animal> &animals, std::vector<Hunter> &hunters);
+    // the hashes index animals/hunters for the dash and slam
+    void update(float dt, Tilemap &world, const Camera2D &cam, std::vector<Animal> &animals, std::vector<Hunter> &hunters,
+                const SpatialHash &animalHash, const SpatialHash &hunterHash);
     void draw() const;
     Vector2 getPosition() const { return pos; }
 
@@ -83,7 +86,8 @@ public:
     }
 
     // stage 1 bite function, returns number of things consumed
-    int tryBite(std::vector<Animal> &animals, std::vector<Hunter> &hunters);
+    int tryBite(std::vector<Animal> &animals, std::vector<Hunter> &hunters, const SpatialHash &animalHash,
+                const SpatialHash &hunterHash);
 
     float getBiteCooldownFraction() const
     {
@@ -147,6 +151,9 @@ public:
     void resetForNewRun(Vector2 spawn);
 
 private:
+    // after evolving: smash the rock the bigger body would overlap, so it never starts in a wall
+    void growInto(Tilemap &world);
+
     Vector2 pos;
     float radius = 14.0f;
     Color bodyColor = WHITE;
@@ -0,0 +1,93 @@
+#include "RegionLabeler.hpp"
+#include <algorithm>
+
+int RegionLabeler::findRoot(int a)
+{
+    int root = a;
+    while (parent[root] != root)
+        root = parent[root];
+    // path compression
+    while (parent[a] != root)
+    {
+        int next = parent[a];
+        parent[a] = root;
+        a = next;
+    }
+    return root;
+}
+
+void RegionLabeler::unite(int a, int b)
+{
+    a = findRoot(a);
+    b = findRoot(b);
+    // smaller label wins so the root is always the first label seen in scan order
+    if (a < b)
+        parent[b] = a;
+    else if (b < a)
+        parent[a] = b;
+}
+
+int RegionLabeler::label(const uint8_t *cells, int width, int height, std::vector<int> &labels, std::vector<RegionInfo> &regions)
+{
+    labels.assign((size_t)width * height, -1);
+    regions.clear();
+    parent.clear();
+
+    // pass 1: provisional labels from the left and upper neighbours
+    for (int y = 1; y < height - 1; ++y)
+    {
+        const uint8_t *row = cells + (size_t)y * width;
+        int *lab = &labels[(size_t)y * width];
+        const int *labUp = lab - width;
+        for (int x = 1; x < width - 1; ++x)
+        {
+            if (row[x])
+                continue;
+            int left = lab[x - 1]; // x-1 == 0 is border, always -1
+            int up = (y > 1) ? labUp[x] : -1;
+            if (left < 0 && up < 0)
+            {
+                lab[x] = (int)parent.size();
+                parent.push_back(lab[x]);
+            }
+            else if (left < 0)
+                lab[x] = up;
+            else if (up < 0 || up == left)
+                lab[x] = left;
+            else
+            {
+                lab[x] = std::min(left, up);
+                unite(left, up);
+            }
+        }
+    }
+
+    // pass 2: resolve roots, number regions in order of first appearance, sizes and boxes
+    finalId.assign(parent.size(), -1);
+    for (int y = 1; y < height - 1; ++y)
+    {
+        int *lab = &labels[(size_t)y * width];
+        for (int x = 1; x < width - 1; ++x)
+        {
+            if (lab[x] < 0)
+                continue;
+            int root = findRoot(lab[x]);
+            int id = finalId[root];
+            if (id < 0)
+            {
+                id = finalId[root] = (int)regions.size();
+                RegionInfo r;
+                r.minX = r.maxX = x;
+                r.minY = r.maxY = y;
+                regions.push_back(r);
+            }
+            lab[x] = id;
+            RegionInfo &r = regions[id];
+            r.size++;
+            r.minX = std::min(r.minX, x);
+            r.maxX = std::max(r.maxX, x);
+            r.maxY = y; // rows only go down
+        }
+    }
+    return (int)regions.size();
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// one connected floor region
+struct RegionInfo
+{
+    int size = 0;
+    int minX = 0, minY = 0, maxX = 0, maxY = 0; // bounding box in tiles, inclusive
+};
+
+/*
+Connected component labelling for floor tiles (4-connected, same as the old BFS flood fill).
+Two scanline passes: the first gives each floor tile a provisional label and merges labels
+that touch in a union-find with path compression, the second resolves every tile to its
+final region id and gathers sizes and bounding boxes on the way.
+
+Region ids are handed out in row-major order of each region's first tile, so the result
+matches a BFS flood fill started from each unvisited tile in scan order.
+The outer ring of the map is never part of a region.
+*/
+class RegionLabeler
+{
+public:
+    // cells: one byte per tile, nonzero = wall. labelsOut gets -1 for walls.
+    // returns the number of regions
+    int label(const uint8_t *cells, int width, int height, std::vector<int> &labelsOut, std::vector<RegionInfo> &regionsOut);
+
+private:
+    std::vector<int> parent; // provisional label -> parent, reused between calls
+    std::vector<int> finalId;
+
+    int findRoot(int a);
+    void unite(int a, int b);
+};
@@ -0,0 +1,39 @@
+#include "SightGrid.hpp"
+
+bool SightGrid::lineClear(int x0, int y0, int x1, int y1) const
+{
+    const int W = bits.width, H = bits.height;
+    if ((unsigned)x0 >= (unsigned)W || (unsigned)y0 >= (unsigned)H || (unsigned)x1 >= (unsigned)W ||
+        (unsigned)y1 >= (unsigned)H)
+        return false;
+
+    const uint64_t *words = bits.words.data();
+    const size_t stride = (size_t)bits.wordsPerRow;
+    // far end in rock (looking at a wall, or off into the cave walls) fails without the walk
+    if ((words[(size_t)y1 * stride + (x1 >> 6)] >> (x1 & 63)) & 1u)
+        return false;
+    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    const uint64_t *row = words + (size_t)y0 * stride;
+    const ptrdiff_t rowStep = sy * (ptrdiff_t)stride;
+    while (true)
+    {
+        if ((row[x0 >> 6] >> (x0 & 63)) & 1u)
+            return false;
+        if (x0 == x1 && y0 == y1)
+            return true;
+        int e2 = 2 * err;
+        if (e2 >= dy)
+        {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx)
+        {
+            err += dx;
+            y0 += sy;
+            row += rowStep;
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include "BitGrid.hpp"
+
+/*
+Walls as one bit per tile, for line of sight. Same Bresenham walk as the old
+Tilemap::hasLineOfSight (every tile on the line, both ends included, outside the map
+blocks) so answers don't change, but a tile is a shift and a mask on a word that's
+usually already in cache, and the bounds are checked once per line instead of per tile
+(both ends inside means the whole line is).
+
+tilesFor() is what a check costs, for callers that run thousands of them a frame against
+a fixed budget (Tilemap::linesOfSight).
+
+Carving only clears bits (open()), so keeping it current is cheap.
+*/
+class SightGrid
+{
+public:
+    // cells: one byte per tile, nonzero = wall
+    void build(const uint8_t *cells, int width, int height) { bits.fromBytes(cells, width, height); }
+    void open(int x, int y) { bits.set(x, y, false); }
+
+    bool lineClear(int x0, int y0, int x1, int y1) const;
+
+    // tiles the walk from (x0,y0) to (x1,y1) visits
+    static long tilesFor(int x0, int y0, int x1, int y1)
+    {
+        int dx = abs(x1 - x0), dy = abs(y1 - y0);
+        return (dx > dy ? dx : dy) + 1;
+    }
+
+    size_t memoryBytes() const { return bits.words.capacity() * sizeof(uint64_t); }
+
+private:
+    BitGrid bits; // 1 = wall
+};
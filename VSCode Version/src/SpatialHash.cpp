@@ -0,0 +1,64 @@
+#include "SpatialHash.hpp"
+
+void SpatialHash::reset(size_t count)
+{
+    // about two buckets an entity, at least 64
+    size_t buckets = 64;
+    while (buckets < count * 2)
+        buckets *= 2;
+    heads.assign(buckets, -1);
+    mask = (unsigned)buckets - 1;
+    items.resize(count);
+    maxRadius = 0.0f;
+}
+
+void SpatialHash::insert(int index, Vector2 pos, float radius)
+{
+    Item &it = items[index];
+    it.x = pos.x;
+    it.y = pos.y;
+    it.r = radius;
+    it.cx = (int)floorf(pos.x / cell);
+    it.cy = (int)floorf(pos.y / cell);
+    if (radius > maxRadius)
+        maxRadius = radius;
+    link(index);
+}
+
+void SpatialHash::link(int index)
+{
+    Item &it = items[index];
+    int &head = heads[bucketOf(it.cx, it.cy)];
+    it.prev = -1;
+    it.next = head;
+    if (head >= 0)
+        items[head].prev = index;
+    head = index;
+}
+
+void SpatialHash::unlink(int index)
+{
+    Item &it = items[index];
+    if (it.prev >= 0)
+        items[it.prev].next = it.next;
+    else
+        heads[bucketOf(it.cx, it.cy)] = it.next;
+    if (it.next >= 0)
+        items[it.next].prev = it.prev;
+}
+
+void SpatialHash::move(int index, Vector2 pos)
+{
+    if ((unsigned)index >= (unsigned)items.size())
+        return;
+    Item &it = items[index];
+    it.x = pos.x;
+    it.y = pos.y;
+    int cx = (int)floorf(pos.x / cell), cy = (int)floorf(pos.y / cell);
+    if (cx == it.cx && cy == it.cy)
+        return;
+    unlink(index);
+    it.cx = cx;
+    it.cy = cy;
+    link(index);
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include <raylib.h>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/*
+Broadphase for one kind of entity (animals, hunters). Every entity goes into the CELL px
+square its centre is in, and cells are hashed into a power of two bucket table with a
+doubly linked list per bucket, so an entity that walks into the next cell is moved in O(1).
+Rebuilt once a tick from the entity vector, then kept up to date with move() as things walk.
+
+Queries visit the index of every entity whose circle touches the shape, nearest cells only,
+so a bite or a bullet costs the few entities around it rather than the whole vector. Dead
+entities are kept (the vector still holds them until the end of the tick), callers skip them.
+The callback can't add or remove entities, marking them dead is fine.
+*/
+class SpatialHash
+{
+public:
+    static constexpr float DEFAULT_CELL = 64.0f; // two tiles
+    static const int SCAN_BELOW = 16;            // fewer entities than this, queries just check them all
+
+    void setCellSize(float px) { cell = px; }
+
+    // every entity of the vector by index, anything with .pos and .radius
+    template <typename T>
+    void build(const std::vector<T> &entities)
+    {
+        reset(entities.size());
+        for (size_t i = 0; i < entities.size(); ++i)
+            insert((int)i, entities[i].pos, entities[i].radius);
+    }
+    void move(int index, Vector2 pos); // entity 'index' walked to pos
+
+    int size() const { return (int)items.size(); }
+    size_t memoryBytes() const { return items.capacity() * sizeof(Item) + heads.capacity() * sizeof(int); }
+
+    // distance between centres <= r + entity radius
+    template <typename Fn>
+    void circle(Vector2 c, float r, Fn &&fn) const
+    {
+        forCells(c.x - r, c.y - r, c.x + r, c.y + r, [&](const Item &it, int i)
+                 {
+            float dx = it.x - c.x, dy = it.y - c.y, rr = r + it.r;
+            if (dx * dx + dy * dy <= rr * rr)
+                fn(i); });
+    }
+
+    // like circle, and the centre is within acos(cosHalf) of dir (dir unit length)
+    template <typename Fn>
+    void sector(Vector2 c, float r, Vector2 dir, float cosHalf, Fn &&fn) const
+    {
+        circle(c, r, [&](int i)
+               {
+            const Item &it = items[i];
+            float dx = it.x - c.x, dy = it.y - c.y;
+            float d = sqrtf(dx * dx + dy * dy);
+            if (d > 1e-4f && dir.x * dx + dir.y * dy >= cosHalf * d)
+                fn(i); });
+    }
+
+    // distance from the centre to the segment a-b <= pad + entity radius
+    template <typename Fn>
+    void segment(Vector2 a, Vector2 b, float pad, Fn &&fn) const
+    {
+        const float abx = b.x - a.x, aby = b.y - a.y;
+        const float ab2 = abx * abx + aby * aby;
+        auto test = [&](const Item &it, int i)
+        {
+            float t = (ab2 > 1e-8f) ? ((it.x - a.x) * abx + (it.y - a.y) * aby) / ab2 : 0.0f;
+            t = fminf(1.0f, fmaxf(0.0f, t));
+            float dx = it.x - (a.x + abx * t), dy = it.y - (a.y + aby * t), rr = pad + it.r;
+            if (dx * dx + dy * dy <= rr * rr)
+                fn(i);
+        };
+        if ((int)items.size() < SCAN_BELOW)
+        {
+            for (int i = 0; i < (int)items.size(); ++i)
+                test(items[i], i);
+            return;
+        }
+
+        // a row of cells at a time, only the stretch of the row the fattened segment crosses
+        const float ext = pad + maxRadius, inv = 1.0f / cell;
+        int cy0 = (int)floorf((fminf(a.y, b.y) - ext) * inv), cy1 = (int)floorf((fmaxf(a.y, b.y) + ext) * inv);
+        for (int cy = cy0; cy <= cy1; ++cy)
+        {
+            float lo = cy * cell - ext, hi = (cy + 1) * cell + ext;
+            float t0 = 0.0f, t1 = 1.0f;
+            if (fabsf(aby) > 1e-6f)
+            {
+                t0 = (lo - a.y) / aby;
+                t1 = (hi - a.y) / aby;
+                if (t0 > t1)
+                    std::swap(t0, t1);
+                t0 = fmaxf(t0, 0.0f);
+                t1 = fminf(t1, 1.0f);
+                if (t0 > t1)
+                    continue;
+            }
+            float x0 = a.x + abx * t0, x1 = a.x + abx * t1;
+            if (x0 > x1)
+                std::swap(x0, x1);
+            int cx0 = (int)floorf((x0 - ext) * inv), cx1 = (int)floorf((x1 + ext) * inv);
+            for (int cx = cx0; cx <= cx1; ++cx)
+                forCell(cx, cy, test);
+        }
+    }
+
+private:
+    struct Item
+    {
+        float x, y, r;
+        int cx, cy;
+        int prev, next; // bucket list, -1 ends
+    };
+
+    float cell = DEFAULT_CELL;
+    float maxRadius = 0.0f;
+    std::vector<Item> items;
+    std::vector<int> heads; // first item of each bucket, -1 empty
+    unsigned mask = 0;
+
+    void reset(size_t count);
+    void insert(int index, Vector2 pos, float radius);
+    void link(int index);
+    void unlink(int index);
+
+    unsigned bucketOf(int cx, int cy) const { return ((unsigned)cx * 73856093u ^ (unsigned)cy * 19349663u) & mask; }
+
+    template <typename Fn>
+    void forCell(int cx, int cy, Fn &&fn) const
+    {
+        // other cells can share the bucket, only theirs count
+        for (int i = heads[bucketOf(cx, cy)]; i >= 0; i = items[i].next)
+            if (items[i].cx == cx && items[i].cy == cy)
+                fn(items[i], i);
+    }
+
+    // cells touching the box grown by the biggest radius, or every item if that's cheaper
+    template <typename Fn>
+    void forCells(float x0, float y0, float x1, float y1, Fn &&fn) const
+    {
+        if (items.empty())
+            return;
+        const float inv = 1.0f / cell;
+        int cx0 = (int)floorf((x0 - maxRadius) * inv), cx1 = (int)floorf((x1 + maxRadius) * inv);
+        int cy0 = (int)floorf((y0 - maxRadius) * inv), cy1 = (int)floorf((y1 + maxRadius) * inv);
+        if ((int)items.size() < SCAN_BELOW || (long)(cx1 - cx0 + 1) * (cy1 - cy0 + 1) >= (long)items.size())
+        {
+            for (int i = 0; i < (int)items.size(); ++i)
+                fn(items[i], i);
+            return;
+        }
+        for (int cy = cy0; cy <= cy1; ++cy)
+            for (int cx = cx0; cx <= cx1; ++cx)
+                forCell(cx, cy, fn);
+    }
+};
@@ -1,531 +1,702 @@
 #include "Tilemap.hpp"
+#include "BitGrid.hpp"
+#include "Pathfinder.hpp"
 #include <random>
-#include <queue>
 #include <algorithm>
+#include <cassert>
+#include <chrono>
 #include <cmath>
-#include <raymath.h>
 
-bool Tilemap::isWall(int tx, int ty) const
+Tilemap::Tilemap(int w, int h)
 {
-    if (tx < 0 || ty < 0 || tx >= WIDTH || ty >= HEIGHT)
-        return true;
-    return map[ty][tx] == 1;
+    resize(w, h);
+}
+
+void Tilemap::resize(int newWidth, int newHeight)
+{
+    width = std::max(newWidth, 3);
+    height = std::max(newHeight, 3);
+    tiles.assign((size_t)width * height, 1);
+    rebuildFloorIndex();
+    clearance.build(tiles.data(), width, height);
+    invalidateClusters();
+    components.build(tiles.data(), width, height);
+    sight.build(tiles.data(), width, height);
+    editVersion++;
+    resetOpenedLog();
+}
+
+size_t Tilemap::memoryBytes() const
+{
+    return sizeof(*this) + tiles.capacity() + clearance.memoryBytes() + clusters.memoryBytes() +
+           floorList.capacity() * sizeof(uint32_t) + components.memoryBytes() + sight.memoryBytes() +
+           openedLog.size() * sizeof(OpenedTile);
 }
 
 void Tilemap::draw() const
 {
-    for (int y = 0; y < HEIGHT; ++y)
+    draw(Rectangle{0.0f, 0.0f, (float)width * TILE_SIZE, (float)height * TILE_SIZE});
+}
+
+void Tilemap::draw(Rectangle view) const
+{
+    // clip to the visible tiles, a 4096 map is 16M rectangles otherwise
+    int minX = std::max(0, (int)floorf(view.x / TILE_SIZE));
+    int minY = std::max(0, (int)floorf(view.y / TILE_SIZE));
+    int maxX = std::min(width - 1, (int)floorf((view.x + view.width) / TILE_SIZE));
+    int maxY = std::min(height - 1, (int)floorf((view.y + view.height) / TILE_SIZE));
+
+    for (int y = minY; y <= maxY; ++y)
     {
-        for (int x = 0; x < WIDTH; ++x)
+        for (int x = minX; x <= maxX; ++x)
         {
-            Color c = map[y][x] ? Color{30, 45, 55, 255} : Color{18, 120, 100, 255};
+            Color c = at(x, y) ? Color{30, 45, 55, 255} : Color{18, 120, 100, 255};
             DrawRectangle(x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE, c);
+        }
+    }
+}
 
-            /* old world gen code
-            Rectangle r{(float)x * TILE_SIZE, (float)y * TILE_SIZE,
-                        (float)TILE_SIZE, (float)TILE_SIZE};
-            if (map[y][x])
-            {
-                DrawRectangleRec(r, Color{30, 45, 55, 255});
-            }
-            else
-            {
-                DrawRectangleRec(r, Color{18, 120, 100, 255});
-            }
-            */
+// how far a circle at p can go along x (axis 0) or y (axis 1), up to 'move', before it touches a
+// wall. a wall tile beside the path stops it where the circle meets the tile's face or corner.
+// stops a hair short so the next sweep along the other axis doesn't catch on the same wall
+float Tilemap::sweepAxis(Vector2 p, float radius, float move, int axis) const
+{
+    const float SKIN = 0.01f;
+    if (move == 0.0f)
+        return 0.0f;
+    const float T = (float)TILE_SIZE;
+    const float along = axis == 0 ? p.x : p.y, across = axis == 0 ? p.y : p.x;
+    const int dir = move > 0.0f ? 1 : -1;
+    const int from = (int)floorf(along / T) + dir;
+    const int to = (int)floorf((along + move + dir * radius) / T);
+    const int j0 = (int)floorf((across - radius) / T), j1 = (int)floorf((across + radius) / T);
+
+    float allowed = move;
+    for (int k = from; dir > 0 ? k <= to : k >= to; k += dir)
+    {
+        const float face = dir > 0 ? k * T : (k + 1) * T;
+        bool hit = false;
+        for (int j = j0; j <= j1; ++j)
+        {
+            if (axis == 0 ? !isWall(k, j) : !isWall(j, k))
+                continue;
+            // how far the circle reaches towards the face at this tile's offset (less at a corner)
+            float lo = j * T, hi = lo + T;
+            float gap = across < lo ? lo - across : (across > hi ? across - hi : 0.0f);
+            if (gap >= radius)
+                continue;
+            float reach = sqrtf(radius * radius - gap * gap) + SKIN;
+            float a = face - dir * reach - along;
+            a = dir > 0 ? fmaxf(a, 0.0f) : fminf(a, 0.0f); // already touching, don't push back
+            if (fabsf(a) < fabsf(allowed))
+                allowed = a;
+            hit = true;
         }
+        // with radius <= a tile nothing further along can stop it sooner
+        if (hit)
+            break;
+    }
+    return allowed;
+}
+
+bool Tilemap::resolveCollision(Vector2 &pos, float radius, Vector2 delta) const
+{
+    assert(radius <= MAX_BODY_RADIUS);
+    const float r = fmaxf(1.0f, radius);
+    // out in the open, nothing within reach of the move
+    if (clearanceAt(pos) > r + fabsf(delta.x) + fabsf(delta.y))
+    {
+        pos.x += delta.x;
+        pos.y += delta.y;
+        return false;
     }
+    float dx = sweepAxis(pos, r, delta.x, 0);
+    pos.x += dx;
+    float dy = sweepAxis(pos, r, delta.y, 1);
+    pos.y += dy;
+    return dx != delta.x || dy != delta.y;
 }
 
-// basic collision function
-void Tilemap::resolveCollision(Vector2 &pos, float radius, Vector2 delta) const
+int Tilemap::resolveCollisions(Mover *movers, int count) const
 {
-    Vector2 next = {pos.x + delta.x, pos.y + delta.y};
-    int tx = (int)(next.x / TILE_SIZE), ty = (int)(next.y / TILE_SIZE);
-    if (!isWall(tx, ty))
-        pos = next;
+    int blocked = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        Mover &m = movers[i];
+        m.blocked = resolveCollision(m.pos, m.radius, m.delta);
+        blocked += m.blocked;
+    }
+    return blocked;
 }
 
-// Cave generation
-int Tilemap::countWallNeighbours(int x, int y) const
+bool Tilemap::circleHitsWall(Vector2 p, float radius) const
 {
-    int cnt = 0;
-    for (int dy = -1; dy <= 1; ++dy)
+    // small circles only cover a couple of tiles, the loop is as cheap as the lookup.
+    // bigger ones are usually nowhere near a wall
+    if (radius >= TILE_SIZE * 0.5f && clearanceAt(p) > radius)
+        return false;
+
+    int minTx = (int)((p.x - radius) / TILE_SIZE);
+    int minTy = (int)((p.y - radius) / TILE_SIZE);
+    int maxTx = (int)((p.x + radius) / TILE_SIZE);
+    int maxTy = (int)((p.y + radius) / TILE_SIZE);
+    for (int ty = minTy; ty <= maxTy; ++ty)
     {
-        for (int dx = -1; dx <= 1; ++dx)
+        for (int tx = minTx; tx <= maxTx; ++tx)
         {
-            if (dx == 0 && dy == 0)
+            if (!isWall(tx, ty))
                 continue;
-            int nx = x + dx, ny = y + dy;
-            if (nx < 0 || ny < 0 || nx >= WIDTH || ny >= HEIGHT)
-            {
-                cnt++;
-                continue;
-            }
-            if (map[ny][nx] == 1)
-                cnt++;
+            Rectangle t{(float)tx * TILE_SIZE, (float)ty * TILE_SIZE, (float)TILE_SIZE, (float)TILE_SIZE};
+            if (CheckCollisionCircleRec(p, radius, t))
+                return true;
         }
     }
-    return cnt;
+    return false;
+}
+
+// stopwatch for CaveGenStats, ms since t and restarts t
+static double lapMs(std::chrono::steady_clock::time_point &t)
+{
+    auto now = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(now - t).count();
+    t = now;
+    return ms;
+}
+
+void Tilemap::finishGenerate(CaveGenStats *stats)
+{
+    auto lap = std::chrono::steady_clock::now();
+    rebuildFloorIndex();
+    clearance.build(tiles.data(), width, height);
+    invalidateClusters();
+    components.build(tiles.data(), width, height);
+    sight.build(tiles.data(), width, height);
+    editVersion++;
+    resetOpenedLog();
+    if (stats)
+    {
+        stats->indexMs = lapMs(lap);
+        stats->regionsAfter = components.regionCount();
+    }
 }
 
-void Tilemap::generateCave(unsigned seed, int fillPercent, int smoothSteps)
+// Cave generation
+void Tilemap::generateCave(unsigned seed, int fillPercent, int smoothSteps, CaveGenStats *stats)
 {
+    auto lap = std::chrono::steady_clock::now();
+    CaveGenStats local;
+    CaveGenStats &st = stats ? *stats : local;
+
     fillPercent = std::clamp(fillPercent, 1, 99);
     smoothSteps = std::clamp(smoothSteps, 1, 8);
 
     std::mt19937 rng(seed);
     std::uniform_int_distribution<int> d100(0, 99);
 
+    // fresh cave, forget any breach from the last one
+    breachFlag = false;
+    lastBreachPos = {};
+
     // randomly fill map
-    for (int y = 0; y < HEIGHT; ++y)
+    for (int y = 0; y < height; ++y)
     {
-        for (int x = 0; x < WIDTH; ++x)
+        for (int x = 0; x < width; ++x)
         {
-            bool border = (x == 0 || y == 0 || x == WIDTH - 1 || y == HEIGHT - 1);
-            map[y][x] = border ? 1 : (d100(rng) < fillPercent ? 1 : 0);
+            bool border = (x == 0 || y == 0 || x == width - 1 || y == height - 1);
+            at(x, y) = border ? 1 : (d100(rng) < fillPercent ? 1 : 0);
         }
     }
+    st.fillMs = lapMs(lap);
 
     /*Smooth using following rule:
         If 5 or more neighbouring cells are walls then cell is wall, else keep the same
+      rows are packed 64 tiles to a word and counted with bitwise adders (see BitGrid)
     */
+    BitGrid cur, next;
+    cur.fromBytes(tiles.data(), width, height);
     for (int step = 0; step < smoothSteps; ++step)
     {
-        int next[HEIGHT][WIDTH];
-        for (int y = 0; y < HEIGHT; ++y)
-        {
-            for (int x = 0; x < WIDTH; ++x)
-            {
-                if (x == 0 || y == 0 || x == WIDTH - 1 || y == HEIGHT - 1)
-                {
-                    next[y][x] = 1;
-                    continue;
-                }
-                int n = countWallNeighbours(x, y);
-                if (n > 4)
-                    next[y][x] = 1;
-                else if (n < 4)
-                    next[y][x] = 0;
-                else
-                    next[y][x] = map[y][x];
-            }
-        }
-        for (int y = 0; y < HEIGHT; ++y)
-        {
-            for (int x = 0; x < WIDTH; ++x)
-            {
-                map[y][x] = next[y][x];
-            }
-        }
+        smoothCaveBits(cur, next, 0);
+        std::swap(cur, next);
     }
+    cur.toBytes(tiles.data());
+    st.smoothMs = lapMs(lap);
 
     // Keep larget floor region , fill empty spaces
-    keepLargestRegionAndFillOthers();
+    st.regionsBefore = keepLargestRegionAndFillOthers();
+    st.cleanupMs = lapMs(lap);
 
-    // Connect remains empty spaces (corridor generation)
-    connectRegionsToMain();
+    finishGenerate(stats);
 }
 
-void Tilemap::floodFillRegions(std::vector<int> &regionIdOut, int &regionCount) const
+void Tilemap::rebuildFloorIndex()
 {
-    regionIdOut.assign(WIDTH * HEIGHT, -1);
-    regionCount = 0;
-    auto idx = [&](int x, int y)
-    { return y * WIDTH + x; };
-
-    for (int y = 0; y < HEIGHT; ++y)
+    floorList.clear();
+    for (size_t i = 0; i < tiles.size(); ++i)
     {
-        for (int x = 0; x < WIDTH; ++x)
-        {
-            if (map[y][x] == 1)
-                continue;
-            if (regionIdOut[idx(x, y) != -1])
-                continue;
+        if (tiles[i] == 0)
+            floorList.push_back((uint32_t)i);
+    }
+}
 
-            int id = regionCount++;
-            std::queue<std::pair<int, int>> q;
-            q.push({x, y});
-            regionIdOut[idx(x, y)] = id;
+void Tilemap::generateNoiseCave(unsigned seed, const NoiseCaveParams &params, int threads, CaveGenStats *stats)
+{
+    auto lap = std::chrono::steady_clock::now();
+    CaveGenStats local;
+    CaveGenStats &st = stats ? *stats : local;
 
-            while (!q.empty())
-            {
-                auto [cx, cy] = q.front();
-                q.pop();
-                static const int DIRS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
-                for (auto &d : DIRS)
-                {
-                    int nx = cx + d[0], ny = cy + d[1];
-                    if (nx <= 0 || ny <= 0 || nx >= WIDTH - 1 || ny >= HEIGHT - 1)
-                        continue;
-                    if (map[ny][nx] == 1)
-                        continue;
-                    int &tag = regionIdOut[idx(nx, ny)];
-                    if (tag == -1)
-                    {
-                        tag = id;
-                        q.push({nx, ny});
-                    }
-                }
-            }
-        }
-    }
+    breachFlag = false;
+    lastBreachPos = {};
+
+    fillNoiseCave(seed, params, 0, 0, width, height, tiles.data(), threads);
+
+    // solid border like the cellular caves
+    for (int x = 0; x < width; ++x)
+        at(x, 0) = at(x, height - 1) = 1;
+    for (int y = 0; y < height; ++y)
+        at(0, y) = at(width - 1, y) = 1;
+
+    st.fillMs = lapMs(lap);
+
+    // noise leaves plenty of small pockets, keep the biggest cave only
+    st.regionsBefore = keepLargestRegionAndFillOthers();
+    st.cleanupMs = lapMs(lap);
+
+    finishGenerate(stats);
 }
 
-void Tilemap::keepLargestRegionAndFillOthers()
+int Tilemap::labelRegions(std::vector<int> &regionIdOut, std::vector<RegionInfo> &regionsOut) const
+{
+    // union-find scanline labelling, gives sizes and bounding boxes in the same pass
+    RegionLabeler labeler;
+    return labeler.label(tiles.data(), width, height, regionIdOut, regionsOut);
+}
+
+int Tilemap::keepLargestRegionAndFillOthers()
 {
     std::vector<int> regionId;
-    int regionCount = 0;
-    floodFillRegions(regionId, regionCount);
+    std::vector<RegionInfo> regions;
+    int regionCount = labelRegions(regionId, regions);
     if (regionCount <= 1)
-        return;
+        return regionCount;
 
-    // count sizes
-    std::vector<int> size(regionCount, 0);
-    for (int y = 0; y < HEIGHT; ++y)
+    int mainId = (int)(std::max_element(regions.begin(), regions.end(), [](const RegionInfo &a, const RegionInfo &b)
+                                        { return a.size < b.size; }) -
+                       regions.begin());
+
+    // fill other regions
+    for (size_t i = 0; i < tiles.size(); ++i)
     {
-        for (int x = 0; x < WIDTH; ++x)
-        {
-            if (map[y][x] == 0)
-                size[regionId[y * WIDTH + x]]++;
-        }
+        if (regionId[i] >= 0 && regionId[i] != mainId)
+            tiles[i] = 1;
     }
-    int mainId = (int)(std::max_element(size.begin(), size.end()) - size.begin());
+    return regionCount;
+}
 
-    // fill other regions
-    for (int y = 0; y < HEIGHT; ++y)
+// spawnpoint allocation
+Vector2 Tilemap::pickSpawnFloorNearCenter() const
+{
+    int cx = width / 2, cy = height / 2;
+    const int R = std::max(width, height);
+    // only the main cave, never a pocket the player can't get out of
+    const int main = components.largest();
+    auto usable = [&](int x, int y)
+    { return x > 1 && y > 1 && x < width - 1 && y < height - 1 && !isWall(x, y) && components.at(x, y) == main; };
+
+    // walk only the outline of each square ring, the inside was checked on the smaller rings.
+    // same row-major order as scanning the whole square so the result doesn't change
+    for (int r = 0; r < R; ++r)
     {
-        for (int x = 0; x < WIDTH; ++x)
+        for (int dy = -r; dy <= r; ++dy)
         {
-            int id = regionId[y * WIDTH + x];
-            if (map[y][x] == 0 && id != mainId)
-                map[y][x] = 1;
+            int y = cy + dy;
+            bool edgeRow = (dy == -r || dy == r);
+            int step = edgeRow ? 1 : 2 * r;
+            for (int dx = -r; dx <= r; dx += step)
+            {
+                if (usable(cx + dx, y))
+                    return Vector2{(cx + dx + 0.5f) * TILE_SIZE, (y + 0.5f) * TILE_SIZE};
+            }
         }
     }
+    return Vector2{(float)cx * TILE_SIZE, (float)cy * TILE_SIZE};
 }
 
-void Tilemap::connectRegionsToMain()
+// rand(lo, hi) is inclusive like GetRandomValue.
+// a few random picks from the floor list first, if the rules keep rejecting them
+// scan the list from a random start so a valid tile is always found when one exists
+template <typename Rand>
+bool Tilemap::sampleFloor(Rand rand, const FloorQuery *q, Vector2 &out) const
 {
-    /*
-    After keepLargestRegionAndFillOthers(), any floor left is already main, but the smoothing might still leave narrow breaks.
-    This code will carve winding connections to empty pockets
-    */
+    const int n = (int)floorList.size();
+    if (n == 0)
+        return false;
 
-    // Find approximate biggest open area for starting position
-    Vector2 center = {WIDTH * 0.5f, HEIGHT * 0.5f};
-    int cx = (int)center.x, cy = (int)center.y;
-    // Adjust to nearest floor
-    for (int r = 0; r < 20 && map[cy][cx] == 1; ++r)
+    int fromX = 0, fromY = 0, fromRegion = -1;
+    float minD2 = 0.0f;
+    if (q)
     {
-        if (cx + 1 < WIDTH && map[cy][cx + 1] == 0)
-        {
-            cx++;
-            break;
-        }
-        if (cx - 1 >= 0 && map[cy][cx - 1] == 0)
-        {
-            cx--;
-            break;
-        }
-        if (cy + 1 < HEIGHT && map[cy + 1][cx] == 0)
-        {
-            cy++;
-            break;
-        }
-        if (cy - 1 >= 0 && map[cy - 1][cx] == 0)
+        worldToTile(q->from, fromX, fromY);
+        minD2 = q->minDistTiles * q->minDistTiles;
+        if (q->reachable)
         {
-            cy--;
-            break;
+            fromRegion = components.at(fromX, fromY);
+            if (fromRegion < 0)
+                return false; // standing in a wall, nothing counts as reachable
         }
     }
 
-    std::mt19937 rng(12345);
-    std::uniform_int_distribution<int> turn(0, 100);
-
-    // random walks to create winding passages
-    for (int w = 0; w < 12; ++w)
+    auto accept = [&](uint32_t i)
     {
-        int x = cx, y = cy;
-        int dx = (w % 2 == 0) ? 1 : -1;
-        int dy = (w % 3 == 0) ? 1 : -1;
-        int steps = 120;
-
-        (void)dx;
-        (void)dy;
+        if (!q)
+            return true;
+        int x = (int)(i % width), y = (int)(i / width);
+        float dx = (float)(x - fromX), dy = (float)(y - fromY);
+        if (dx * dx + dy * dy < minD2)
+            return false;
+        return !q->reachable || components.at(x, y) == fromRegion;
+    };
+    auto toWorld = [&](uint32_t i)
+    { return tileToWorldCenter((int)(i % width), (int)(i / width)); };
 
-        while (steps--)
+    for (int tries = 0; tries < 64; ++tries)
+    {
+        uint32_t i = floorList[rand(0, n - 1)];
+        if (accept(i))
         {
-            if (x <= 1 || y <= 1 || x >= WIDTH - 2 || y >= HEIGHT - 2)
-                break;
-
-            map[y][x] = 0; // carve passages
-
-            // widen passages and add irregularity
-            if (turn(rng) < 40 && x + 1 < WIDTH - 1)
-                map[y][x + 1] = 0;
-            if (turn(rng) < 40 && x - 1 > 0)
-                map[y][x - 1] = 0;
-
-            // add random turns
-            if (turn(rng) < 25)
-            {
-                dx = (turn(rng) < 50) ? 1 : -1;
-                dy = 0;
-            }
-            if (turn(rng) < 25)
-            {
-                dy = (turn(rng) < 50) ? 1 : -1;
-                dx = 0;
-            }
+            out = toWorld(i);
+            return true;
         }
     }
-}
 
-// spawnpoint allocation
-Vector2 Tilemap::pickSpawnFloorNearCenter() const
-{
-    int cx = WIDTH / 2, cy = HEIGHT / 2;
-    const int R = std::max(WIDTH, HEIGHT);
-    for (int r = 0; r < R; ++r)
+    int start = rand(0, n - 1);
+    for (int k = 0; k < n; ++k)
     {
-        for (int dy = -r; dy <= r; ++dy)
+        uint32_t i = floorList[(start + k) % n];
+        if (accept(i))
         {
-            for (int dx = -r; dx <= r; ++dx)
-            {
-                int x = cx + dx, y = cy + dy;
-                if (x <= 1 || y <= 1 || x >= WIDTH - 1 || y >= HEIGHT - 1)
-                    continue;
-                if (!isWall(x, y))
-                {
-                    return Vector2{(x + 0.5f) * TILE_SIZE, (y + 0.5f) * TILE_SIZE};
-                }
-            }
+            out = toWorld(i);
+            return true;
         }
     }
-    return Vector2{(float)cx * TILE_SIZE, (float)cy * TILE_SIZE};
+    return false;
+}
+
+// GetRandomValue is rand() based, so on platforms with a 15 bit RAND_MAX
+// big ranges are built from two draws
+static int globalRandom(int lo, int hi)
+{
+    int span = hi - lo;
+    if (span <= 0x7FFF)
+        return GetRandomValue(lo, hi);
+    int r = (GetRandomValue(0, 0x7FFF) << 15) | GetRandomValue(0, 0x7FFF);
+    return lo + r % (span + 1);
 }
 
 Vector2 Tilemap::randomFloorPosition() const
 {
-    for (int tries = 0; tries < 1024; ++tries)
-    {
-        int x = GetRandomValue(1, WIDTH - 2);
-        int y = GetRandomValue(1, HEIGHT - 2);
-        if (!isWall(x, y))
-        {
-            return Vector2{(x + 0.5f) * TILE_SIZE, (y + 0.5f) * TILE_SIZE};
-        }
-    }
+    Vector2 p;
+    if (sampleFloor(globalRandom, nullptr, p))
+        return p;
+    // no floor at all, center is as good as anything
+    return Vector2{(width * 0.5f) * TILE_SIZE, (height * 0.5f) * TILE_SIZE};
+}
 
-    // Fallbak to center
-    return Vector2{(WIDTH * 0.5f) * TILE_SIZE, (HEIGHT * 0.5f) * TILE_SIZE};
+Vector2 Tilemap::randomFloorPosition(std::mt19937 &rng) const
+{
+    Vector2 p;
+    auto rand = [&](int lo, int hi)
+    { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+    if (sampleFloor(rand, nullptr, p))
+        return p;
+    return Vector2{(width * 0.5f) * TILE_SIZE, (height * 0.5f) * TILE_SIZE};
+}
+
+bool Tilemap::randomFloorPosition(const FloorQuery &q, Vector2 &out) const
+{
+    return sampleFloor(globalRandom, &q, out);
+}
+
+bool Tilemap::randomFloorPosition(std::mt19937 &rng, const FloorQuery &q, Vector2 &out) const
+{
+    auto rand = [&](int lo, int hi)
+    { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+    return sampleFloor(rand, &q, out);
+}
+
+void Tilemap::resetOpenedLog()
+{
+    // nothing before now can be replayed
+    openedLog.clear();
+    logStart = editVersion + 1;
+}
+
+bool Tilemap::openedSince(unsigned since, std::vector<int> &out) const
+{
+    if (since + 1 < logStart)
+        return false;
+    size_t first = openedLog.size();
+    while (first > 0 && openedLog[first - 1].version > since)
+        first--;
+    for (size_t i = first; i < openedLog.size(); ++i)
+        out.push_back(openedLog[i].index);
+    return true;
 }
 
 // wall destruction
 bool Tilemap::carveCircle(Vector2 centerWorld, float radiusPx, bool preserveBorder, Vector2 *outBorderBreakPos)
 {
-    int minTx = (int)floorf((centerWorld.x - radiusPx) / TILE_SIZE);
-    int minTy = (int)floorf((centerWorld.y - radiusPx) / TILE_SIZE);
-    int maxTx = (int)floorf((centerWorld.x + radiusPx) / TILE_SIZE);
-    int maxTy = (int)floorf((centerWorld.y + radiusPx) / TILE_SIZE);
-
-    minTx = Clamp(minTx, 0, WIDTH - 1);
-    minTy = Clamp(minTy, 0, HEIGHT - 1);
-    maxTx = Clamp(maxTx, 0, WIDTH - 1);
-    maxTy = Clamp(maxTy, 0, HEIGHT - 1);
+    CarveStamp stamp{centerWorld, radiusPx, preserveBorder};
+    return carveCircles(&stamp, 1, nullptr, outBorderBreakPos);
+}
 
+bool Tilemap::carveCircles(const CarveStamp *stamps, int count, std::vector<int> *changedOut, Vector2 *outBorderBreakPos)
+{
     bool brokeBorder = false;
     Vector2 breakPos{};
 
-    for (int ty = minTy; ty <= maxTy; ++ty)
+    // changed area of each stamp, for patching the clearance field afterwards
+    struct Box
     {
-        for (int tx = minTx; tx <= maxTx; ++tx)
+        int minX, minY, maxX, maxY;
+    };
+    std::vector<Box> boxes;
+
+    for (int i = 0; i < count; ++i)
+    {
+        const CarveStamp &st = stamps[i];
+        int cx, cy, subX, subY;
+        CircleStampCache::snap(st.center.x, TILE_SIZE, cx, subX);
+        CircleStampCache::snap(st.center.y, TILE_SIZE, cy, subY);
+        const CircleSpans &spans = stampCache.get(st.radiusPx, TILE_SIZE, subX, subY);
+
+        Box box{width, height, -1, -1};
+        for (int r = 0; r < spans.rows(); ++r)
         {
-            if (preserveBorder && isBorder(tx, ty))
+            int ty = cy + spans.rowMin + r;
+            if (ty < 0 || ty >= height)
                 continue;
-
-            Rectangle t = {
-                tx * (float)TILE_SIZE,
-                ty * (float)TILE_SIZE,
-                (float)TILE_SIZE,
-                (float)TILE_SIZE};
-
-            if (CheckCollisionCircleRec(centerWorld, radiusPx, t))
+            int x0 = std::max(0, cx + spans.x0[r]);
+            int x1 = std::min(width - 1, cx + spans.x1[r]);
+            for (int tx = x0; tx <= x1; ++tx)
             {
-                if (map[ty][tx] == 1)
+                if (st.preserveBorder && isBorder(tx, ty))
+                    continue;
+                if (at(tx, ty) != 1)
+                    continue;
+
+                at(tx, ty) = 0; // remove wall by making it a floor
+                floorList.push_back((uint32_t)(ty * width + tx));
+                components.open(tx, ty);
+                sight.open(tx, ty);
+                openedLog.push_back({editVersion + 1, ty * width + tx});
+                if (changedOut)
+                    changedOut->push_back(ty * width + tx);
+                box.minX = std::min(box.minX, tx);
+                box.minY = std::min(box.minY, ty);
+                box.maxX = std::max(box.maxX, tx);
+                box.maxY = std::max(box.maxY, ty);
+                if (isBorder(tx, ty))
                 {
-                    map[ty][tx] = 0; // remove wall by making it a floor
-                    if (isBorder(tx, ty))
-                    {
-                        brokeBorder = true;
-                        breakPos = {t.x + t.width * 0.5f, t.y + t.height * 0.5f};
-                    }
+                    brokeBorder = true;
+                    breakPos = tileToWorldCenter(tx, ty);
                 }
             }
         }
+        if (box.maxX >= 0)
+            boxes.push_back(box);
+    }
+
+    if (brokeBorder)
+    {
+        breachFlag = true;
+        lastBreachPos = breakPos;
+        if (outBorderBreakPos)
+            *outBorderBreakPos = breakPos;
+    }
+    if (boxes.empty())
+        return brokeBorder;
 
-        if (brokeBorder)
+    editVersion++;
+    components.settle();
+    while (openedLog.size() > OPENED_LOG_MAX)
+    {
+        // a version cut in half can't be replayed any more
+        logStart = std::max(logStart, openedLog.front().version + 1);
+        openedLog.pop_front();
+    }
+
+    // only the distances around the holes can change. overlapping craters are patched
+    // in one go, scattered ones one at a time so the window doesn't cover the whole map.
+    // the cluster graph gets the same boxes, next time someone asks for it
+    const int pad = 2 * (ClearanceField::CAP_TILES + 1);
+    Box all = boxes[0];
+    long separate = 0;
+    for (auto &b : boxes)
+    {
+        all.minX = std::min(all.minX, b.minX);
+        all.minY = std::min(all.minY, b.minY);
+        all.maxX = std::max(all.maxX, b.maxX);
+        all.maxY = std::max(all.maxY, b.maxY);
+        separate += (long)(b.maxX - b.minX + pad) * (b.maxY - b.minY + pad);
+    }
+    if ((long)(all.maxX - all.minX + pad) * (all.maxY - all.minY + pad) <= separate)
+    {
+        clearance.update(tiles.data(), all.minX, all.minY, all.maxX, all.maxY);
+        queueClusterUpdate(all.minX, all.minY, all.maxX, all.maxY);
+    }
+    else
+    {
+        for (auto &b : boxes)
         {
-            breachFlag = true;
-            lastBreachPos = breakPos;
-            if (outBorderBreakPos)
-                *outBorderBreakPos = breakPos;
+            clearance.update(tiles.data(), b.minX, b.minY, b.maxX, b.maxY);
+            queueClusterUpdate(b.minX, b.minY, b.maxX, b.maxY);
         }
     }
     return brokeBorder;
-};
+}
+
+// cluster graph
+void Tilemap::invalidateClusters()
+{
+    std::lock_guard<std::mutex> hold(clusterLock.m);
+    clusters = ClusterGraph(); // drop the old graph's memory until it's wanted again
+    clustersStale = true;
+    clusterPending.clear();
+}
+
+void Tilemap::queueClusterUpdate(int minX, int minY, int maxX, int maxY)
+{
+    std::lock_guard<std::mutex> hold(clusterLock.m);
+    if (clustersStale)
+        return; // the build will see these tiles anyway
+    if ((int)clusterPending.size() >= CLUSTER_PENDING_MAX)
+    {
+        clusters = ClusterGraph();
+        clustersStale = true;
+        clusterPending.clear();
+        return;
+    }
+    clusterPending.push_back({minX, minY, maxX, maxY});
+}
+
+const ClusterGraph &Tilemap::getClusterGraph() const
+{
+    std::lock_guard<std::mutex> hold(clusterLock.m);
+    if (clustersStale)
+    {
+        clusters.build(tiles.data(), width, height);
+        clustersStale = false;
+    }
+    else
+    {
+        for (const TileBox &b : clusterPending)
+            clusters.update(tiles.data(), b.minX, b.minY, b.maxX, b.maxY);
+    }
+    clusterPending.clear();
+    return clusters;
+}
 
 // line of sight
 bool Tilemap::hasLineOfSight(Vector2 a, Vector2 b) const
 {
-    // fancy line drawing code, named after someone but cant remember who
+    // fancy line drawing code (bresenham), on the bit copy of the walls
     int x0, y0, x1, y1;
     worldToTile(a, x0, y0);
     worldToTile(b, x1, y1);
-    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
-    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
-    int err = dx + dy;
-    while (true)
+    return sight.lineClear(x0, y0, x1, y1);
+}
+
+int Tilemap::linesOfSight(const Vector2 *a, const Vector2 *b, int count, uint64_t *maskOut, long tileBudget,
+                           int first) const
+{
+    long used = 0;
+    for (int i = first; i < count; ++i)
     {
-        if (isWall(x0, y0))
-            return false;
-        if (x0 == x1 && y0 == y1)
-            break;
-        int e2 = 2 * err;
-        if (e2 >= dy)
-        {
-            err += dy;
-            x0 += sx;
-        }
-        if (e2 <= dx)
+        int x0, y0, x1, y1;
+        worldToTile(a[i], x0, y0);
+        worldToTile(b[i], x1, y1);
+        if (tileBudget >= 0)
         {
-            err += dx;
-            y0 += sy;
+            // the first one always runs so a tiny budget still gets somewhere
+            long cost = SightGrid::tilesFor(x0, y0, x1, y1);
+            if (i > first && used + cost > tileBudget)
+                return i;
+            used += cost;
         }
+        uint64_t bit = 1ull << (i & 63);
+        if (sight.lineClear(x0, y0, x1, y1))
+            maskOut[i >> 6] |= bit;
+        else
+            maskOut[i >> 6] &= ~bit;
     }
-    return true;
+    return count;
 }
 
-// pathfinding
-bool Tilemap::findPath(Vector2 startWorld, Vector2 goalWorld, std::vector<Vector2> &outPath) const
+// walks every tile the segment passes through (Amanatides & Woo). going exactly through a
+// corner counts the two tiles beside it as well, same as the no corner cutting rule
+bool Tilemap::segmentClear(Vector2 a, Vector2 b) const
 {
-    // simple grid pathfinding using map tiles
-
-    struct Node
-    {
-        int x, y;   // tile position
-        int g, f;   // cost so far and total cost estimate
-        int px, py; // parent coordinates
-    };
-
-    // convert world coordinates to tile grid coordinates
-    int sx, sy, gx, gy;
-    worldToTile(startWorld, sx, sy);
-    worldToTile(goalWorld, gx, gy);
-    // dont path to a wall (obviously)
-    if (isWall(gx, gy))
+    const float x0 = a.x / TILE_SIZE, y0 = a.y / TILE_SIZE;
+    const float dx = b.x / TILE_SIZE - x0, dy = b.y / TILE_SIZE - y0;
+    int tx = (int)floorf(x0), ty = (int)floorf(y0);
+    const int ex = (int)floorf(b.x / TILE_SIZE), ey = (int)floorf(b.y / TILE_SIZE);
+    const int sx = dx > 0.0f ? 1 : -1, sy = dy > 0.0f ? 1 : -1;
+    const float tDeltaX = dx != 0.0f ? fabsf(1.0f / dx) : INFINITY;
+    const float tDeltaY = dy != 0.0f ? fabsf(1.0f / dy) : INFINITY;
+    float tMaxX = dx != 0.0f ? (sx > 0 ? tx + 1 - x0 : x0 - tx) * tDeltaX : INFINITY;
+    float tMaxY = dy != 0.0f ? (sy > 0 ? ty + 1 - y0 : y0 - ty) * tDeltaY : INFINITY;
+
+    if (isWall(tx, ty))
         return false;
-
-    const int W = WIDTH, H = HEIGHT;
-
-    // static caches to avoid large arrays each frame
-    static int openFlag[HEIGHT][WIDTH];
-    static int closedFlag[HEIGHT][WIDTH];
-    static Node parent[HEIGHT][WIDTH];
-    static int stamp = 1;
-    stamp++;
-
-    // gotta love heuristic costs (sarcasm)
-    auto Hcost = [&](int x, int y)
-    { return 10 * (abs(x - gx) + abs(y - gy)); };
-
-    // priority queue using a vector
-    struct Q
+    for (int n = abs(ex - tx) + abs(ey - ty); n > 0; --n)
     {
-        int x, y, f;
-    };
-    std::vector<Q> heap;
-
-    // push helper to maintain order
-    auto push = [&](int x, int y, int f)
-    {heap.push_back({x,y,f}); std::push_heap(heap.begin(), heap.end(), [](const Q&a, const Q&b){return a.f>b.f;}); };
-
-    // pop helper to return node with the smallest f (total cost so far)
-    auto pop = [&]()
-    { std::pop_heap(heap.begin(), heap.end(), [](const Q&a, const Q&b){return a.f>b.f;}); Q q=heap.back(); heap.pop_back(); return q; };
-
-    openFlag[sy][sx] = stamp;
-    parent[sy][sx] = {sx, sy, 0, Hcost(sx, sy), -1, -1};
-    push(sx, sy, parent[sy][sx].f);
-
-    const int DIR8[8][2] = {
-        {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1}};
-
-    // pathfinding loop
-    while (!heap.empty())
-    {
-        Q cur = pop(); // node with lowest f
-        int x = cur.x, y = cur.y;
-        if (closedFlag[y][x] == stamp)
-            continue;
-        closedFlag[y][x] = stamp; // mark as visited
-
-        // goal check
-        if (x == gx && y == gy)
+        if (fabsf(tMaxX - tMaxY) < 1e-5f)
         {
-            // rebuild path by backtracking
-            outPath.clear();
-            while (!(x == sx && y == sy))
-            {
-                outPath.push_back(tileToWorldCenter(x, y));
-                Node p = parent[y][x];
-                x = p.px;
-                y = p.py;
-            }
-            std::reverse(outPath.begin(), outPath.end());
-            return true; // success
+            if (isWall(tx + sx, ty) || isWall(tx, ty + sy))
+                return false;
+            tx += sx;
+            ty += sy;
+            tMaxX += tDeltaX;
+            tMaxY += tDeltaY;
+            n--; // two steps at once
         }
-
-        // explore neighbours in four directions
-        for (int i = 0; i < 8; ++i)
+        else if (tMaxX < tMaxY)
         {
-            int nx = x + DIR8[i][0], ny = y + DIR8[i][1];
-
-            // skip out of bounds
-            if (nx < 0 || ny < 0 || nx >= W || ny >= H)
-                continue;
-            // skip walls
-            if (isWall(nx, ny))
-                continue;
-
-            bool diagonal = (DIR8[i][0] != 0 && DIR8[i][1] != 0);
-            if (diagonal)
-            {
-                int bx = x + DIR8[i][0];
-                int by = y;
-                int cx = x;
-                int cy = y + DIR8[i][1];
-                if (isWall(bx, by) || isWall(cx, cy))
-                    continue;
-            }
-
-            // skip closed tiles
-            if (closedFlag[ny][nx] == stamp)
-                continue;
-
-            // cost to move to neighbour
-            int stepCost = diagonal ? 14 : 10;
-            int g = parent[y][x].g + stepCost;
-
-            // update if neighbours not open or cheaper path found
-            if (openFlag[ny][nx] != stamp || g < parent[ny][nx].g)
-            {
-                parent[ny][nx] = {nx, ny, g, g + Hcost(nx, ny), x, y};
-                openFlag[ny][nx] = stamp;
-                push(nx, ny, parent[ny][nx].f);
-            }
+            tx += sx;
+            tMaxX += tDeltaX;
+        }
+        else
+        {
+            ty += sy;
+            tMaxY += tDeltaY;
         }
+        if (isWall(tx, ty))
+            return false;
     }
-    // edge case, no path is found
-    return false;
-};
+    return true;
+}
+
+bool Tilemap::hasWalkableLine(Vector2 a, Vector2 b, float radius) const
+{
+    // a wall tile is wider than the circle, so anything poking into the swept circle crosses
+    // the middle or one of the edges, or sits in a round end. b is always a tile centre where
+    // the end can't reach a wall, but the first leg of a path starts wherever the hunter is
+    auto centred = [](float v)
+    { return fabsf(v - (floorf(v / TILE_SIZE) + 0.5f) * TILE_SIZE) < 1e-3f; };
+    if (!(centred(a.x) && centred(a.y)) && circleHitsWall(a, radius))
+        return false;
+    float dx = b.x - a.x, dy = b.y - a.y;
+    float L = sqrtf(dx * dx + dy * dy);
+    if (L < 1e-4f)
+        return segmentClear(a, a);
+    Vector2 n = {-dy / L * radius, dx / L * radius};
+    return segmentClear(a, b) && segmentClear({a.x + n.x, a.y + n.y}, {b.x + n.x, b.y + n.y}) &&
+           segmentClear({a.x - n.x, a.y - n.y}, {b.x - n.x, b.y - n.y});
+}
+
+// pathfinding, the search itself lives in Pathfinder so each thread can have its own scratch
+bool Tilemap::findPath(Vector2 startWorld, Vector2 goalWorld, std::vector<Vector2> &outPath) const
+{
+    return Pathfinder::forThread().findPath(*this, startWorld, goalWorld, outPath);
+}
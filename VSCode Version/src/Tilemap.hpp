@@ -1,29 +1,136 @@
 #pragma once
 #include <raylib.h>
 #include <vector>
+#include <deque>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <mutex>
+#include "RegionLabeler.hpp"
+#include "ClearanceField.hpp"
+#include "ClusterGraph.hpp"
+#include "FloorComponents.hpp"
+#include "SightGrid.hpp"
+#include "NoiseCave.hpp"
+#include "CircleStamp.hpp"
+
+// optional timings and counts filled in by the generators (for the bench tools)
+struct CaveGenStats
+{
+    double fillMs = 0.0;    // random fill or noise
+    double smoothMs = 0.0;  // cellular smoothing (0 for noise)
+    double cleanupMs = 0.0; // keepLargestRegionAndFillOthers
+    double indexMs = 0.0;   // floor index, clearance field, regions and sight bits
+    int regionsBefore = 0;  // floor regions before cleanup
+    int regionsAfter = 0;   // and after everything
+};
+
+// one circle for Tilemap::carveCircles
+struct CarveStamp
+{
+    Vector2 center{};
+    float radiusPx = 0.0f;
+    bool preserveBorder = true;
+};
+
+// one entity's move for Tilemap::resolveCollisions, pos is written back
+struct Mover
+{
+    Vector2 pos{};
+    float radius = 0.0f;
+    Vector2 delta{};
+    bool blocked = false; // out: a wall cut the move short
+};
+
+// constraints for picking a random floor tile
+struct FloorQuery
+{
+    Vector2 from{};         // world position the rules are measured from, usually the player
+    float minDistTiles = 0; // at least this many tiles away from 'from'
+    bool reachable = false; // in the same connected floor region as 'from'
+};
 
 class Tilemap
 {
 public:
     static const int TILE_SIZE = 32;
-    static const int WIDTH = 100;
-    static const int HEIGHT = 100;
+    static const int DEFAULT_WIDTH = 100;
+    static const int DEFAULT_HEIGHT = 100;
+
+    Tilemap(int width = DEFAULT_WIDTH, int height = DEFAULT_HEIGHT);
+
+    // map size in tiles, set at runtime (caves up to 4096x4096)
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    void resize(int newWidth, int newHeight); // clears map to solid wall
+
+    // bytes held by the tile grid and everything kept alongside it
+    size_t memoryBytes() const;
+
+    // raw tiles, row major, one byte each (1 = wall)
+    const uint8_t *data() const { return tiles.data(); }
 
     void draw() const;
-    bool isWall(int tx, int ty) const;
+    void draw(Rectangle view) const; // only draws tiles overlapping view (world space)
 
-    // collision
-    void resolveCollision(Vector2 &pos, float radius, Vector2 delta) const;
+    // one byte per tile, row major. unsigned compare folds the 4 bounds checks into 2
+    inline bool isWall(int tx, int ty) const
+    {
+        if ((unsigned)tx >= (unsigned)width || (unsigned)ty >= (unsigned)height)
+            return true;
+        return tiles[(size_t)ty * width + tx] != 0;
+    }
+
+    // collision. the circle is swept along x then y against the wall tiles, so it slides along
+    // walls and can't tunnel at any speed. true if a wall cut the move short.
+    // exact up to a radius of a whole tile (asserted). bodies are collided at the size they're
+    // drawn, anything over half a tile doesn't fit down a one tile corridor. the circle must
+    // start clear of walls, it isn't pushed back out
+    static constexpr float MAX_BODY_RADIUS = (float)TILE_SIZE;
+    bool resolveCollision(Vector2 &pos, float radius, Vector2 delta) const;
+    // every mover in one pass (the animals, say), same result as one call each
+    int resolveCollisions(Mover *movers, int count) const; // returns how many were blocked
+
+    // distance to the nearest wall in px, a lower bound (0 near walls or outside the map)
+    inline float clearanceAt(Vector2 p) const
+    {
+        return clearance.clearanceTiles((int)floorf(p.x / TILE_SIZE), (int)floorf(p.y / TILE_SIZE)) * TILE_SIZE;
+    }
+    // does a circle touch any wall tile. one lookup when it's clear, exact tile test otherwise
+    bool circleHitsWall(Vector2 p, float radius) const;
+    const ClearanceField &getClearance() const { return clearance; }
+    // built on the first call after a generate, carves since the last call are patched in.
+    // only long routes need it, so generating and carving never pay for it. any thread
+    const ClusterGraph &getClusterGraph() const;
+    // connected floor regions, kept current through carves
+    const FloorComponents &getComponents() const { return components; }
 
     // Cave generation
-    void generateCave(unsigned seed = 1337, int fillPercent = 45, int smoothSteps = 5);
+    void generateCave(unsigned seed = 1337, int fillPercent = 45, int smoothSteps = 5, CaveGenStats *stats = nullptr);
+    // fractal noise instead of cellular automaton, rows filled on threads (0 = hardware threads)
+    void generateNoiseCave(unsigned seed = 1337, const NoiseCaveParams &params = NoiseCaveParams{}, int threads = 0, CaveGenStats *stats = nullptr);
     Vector2 pickSpawnFloorNearCenter() const; // finds a spawnpoint in the cave
 
-    // Random points
+    // Random points (raylib's global rng, or your own for worker threads)
+    // picks from the floor index so it is O(1) and never lands in a wall
     Vector2 randomFloorPosition() const;
+    Vector2 randomFloorPosition(std::mt19937 &rng) const;
+    // same but with spawn rules, false if no floor tile satisfies them
+    bool randomFloorPosition(const FloorQuery &q, Vector2 &out) const;
+    bool randomFloorPosition(std::mt19937 &rng, const FloorQuery &q, Vector2 &out) const;
+    int floorTileCount() const { return (int)floorList.size(); }
 
-    // carve floor in a circular aread in world space
+    // carve floor in a circular aread in world space (centre snapped to 1/8 tile)
     bool carveCircle(Vector2 centerWorld, float radiusPx, bool preserveBorder = true, Vector2 *outBorderBreakPos = nullptr);
+    // many circles in one pass, tile indices (y*width+x) that turned to floor are appended to changedOut.
+    // returns true if any of them broke the border
+    bool carveCircles(const CarveStamp *stamps, int count, std::vector<int> *changedOut = nullptr, Vector2 *outBorderBreakPos = nullptr);
+    // goes up every time tiles change, so derived data can tell it's stale
+    unsigned getEditVersion() const { return editVersion; }
+    // appends the tiles (y*width+x) carved open after edit version 'since'. false if that's
+    // too long ago to know (or the whole map changed since), then just start over
+    bool openedSince(unsigned since, std::vector<int> &out) const;
 
     // toggle border destructability
     void setAllowBorderBreak(bool v) { allowBorderBreak = v; }
@@ -51,21 +158,82 @@ public:
 
     // line of sight/vision
     bool hasLineOfSight(Vector2 a, Vector2 b) const;
+    // many at once: bit i of maskOut (64 to a word) is set when a[i] can see b[i]. starts at
+    // 'first' and stops before going over tileBudget tiles walked (< 0 = no limit), returns
+    // where it stopped (count when done) so the next frame can carry on from there
+    int linesOfSight(const Vector2 *a, const Vector2 *b, int count, uint64_t *maskOut, long tileBudget = -1,
+                     int first = 0) const;
+    const SightGrid &getSightGrid() const { return sight; }
+    // can a circle of this radius go straight from a to b without touching a wall. checks every
+    // tile the middle and both edges pass through, so it never slips between diagonal walls
+    bool hasWalkableLine(Vector2 a, Vector2 b, float radius) const;
 
-    // pathfinding
+    // pathfinding, uses the calling thread's Pathfinder so it's safe from any thread
     bool findPath(Vector2 startWorld, Vector2 goalWorld, std::vector<Vector2> &outPath) const;
 
 private:
-    int map[HEIGHT][WIDTH];
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> tiles; // 1 = wall, 0 = floor
+    ClearanceField clearance;   // rebuilt with the cave, patched by carveCircle
+    FloorComponents components; // same, merged as carves join regions
+    SightGrid sight;            // walls as bits for line of sight, cleared as carves open them
+    mutable ClusterGraph clusters; // for long paths, built and patched lazily (see getClusterGraph)
+    CircleStampCache stampCache;
+    unsigned editVersion = 0;
+
+    // recently carved tiles, oldest first. every version from logStart on is complete
+    struct OpenedTile
+    {
+        unsigned version;
+        int index;
+    };
+    static const size_t OPENED_LOG_MAX = 16384;
+    std::deque<OpenedTile> openedLog;
+    unsigned logStart = 1;
+    void resetOpenedLog();
+
+    // dense list of floor tile indices. floor never turns back into wall and carves only
+    // append tiles they just opened, so it needs no per tile slot to stay duplicate free
+    std::vector<uint32_t> floorList;
+    void rebuildFloorIndex();
+
+    template <typename Rand>
+    bool sampleFloor(Rand rand, const FloorQuery *q, Vector2 &out) const;
+
+    inline uint8_t &at(int x, int y) { return tiles[(size_t)y * width + x]; }
+    inline uint8_t at(int x, int y) const { return tiles[(size_t)y * width + x]; }
 
     bool allowBorderBreak = false;
     bool breachFlag = false;
     Vector2 lastBreachPos{};
 
-    bool isBorder(int tx, int ty) const { return tx <= 0 || ty <= 0 || tx > WIDTH - 1 || ty >= HEIGHT - 1; };
+    bool segmentClear(Vector2 a, Vector2 b) const; // supercover, no wall tile touched
+    float sweepAxis(Vector2 p, float radius, float move, int axis) const; // how much of move fits
+
+    // cluster graph upkeep, all under clusterLock. a mutex can't be copied or moved, so copies
+    // of the map just get a fresh one
+    struct FreshMutex
+    {
+        std::mutex m;
+        FreshMutex() = default;
+        FreshMutex(const FreshMutex &) {}
+        FreshMutex &operator=(const FreshMutex &) { return *this; }
+    };
+    struct TileBox
+    {
+        int minX, minY, maxX, maxY;
+    };
+    static const int CLUSTER_PENDING_MAX = 64; // more carved boxes than this, just rebuild
+    mutable FreshMutex clusterLock;
+    mutable bool clustersStale = true;           // tiles replaced wholesale, build from scratch
+    mutable std::vector<TileBox> clusterPending; // carved since the graph was last brought up to date
+    void invalidateClusters();
+    void queueClusterUpdate(int minX, int minY, int maxX, int maxY);
+
+    bool isBorder(int tx, int ty) const { return tx <= 0 || ty <= 0 || tx > width - 1 || ty >= height - 1; };
     // Variables for cave generation
-    int countWallNeighbours(int x, int y) const;
-    void floodFillRegions(std::vector<int> &regionIdOut, int &regionCount) const;
-    void keepLargestRegionAndFillOthers();
-    void connectRegionsToMain();
-};
\ No newline at end of file
+    int labelRegions(std::vector<int> &regionIdOut, std::vector<RegionInfo> &regionsOut) const;
+    int keepLargestRegionAndFillOthers(); // returns how many regions there were
+    void finishGenerate(CaveGenStats *stats); // floor index, clearance field, components, stats
+};
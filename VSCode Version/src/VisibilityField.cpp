@@ -0,0 +1,114 @@
+#include "VisibilityField.hpp"
+#include "Tilemap.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+// floor and ceiling of a/b for b > 0, rounding towards -inf/+inf rather than 0
+static int floorDiv(int a, int b) { return (a >= 0) ? a / b : -((-a + b - 1) / b); }
+static int ceilDiv(int a, int b) { return -floorDiv(-a, b); }
+
+// how a quadrant's (depth, col) steps map to tiles: north, east, south, west
+static const int QUAD[4][4] = {
+    // depth dx, dy, col dx, dy
+    {0, -1, 1, 0},
+    {1, 0, 0, 1},
+    {0, 1, 1, 0},
+    {-1, 0, 0, 1}};
+
+void VisibilityField::clear()
+{
+    valid = false;
+}
+
+bool VisibilityField::visible(const Tilemap &world, Vector2 p) const
+{
+    int tx, ty;
+    world.worldToTile(p, tx, ty);
+    return visibleTile(tx, ty);
+}
+
+bool VisibilityField::covers(const Tilemap &world, Vector2 origin, Vector2 from) const
+{
+    if (!valid || editVersion != world.getEditVersion())
+        return false;
+    int tx, ty, fx, fy;
+    world.worldToTile(origin, tx, ty);
+    world.worldToTile(from, fx, fy);
+    return tx == ox && ty == oy && abs(fx - ox) <= radius && abs(fy - oy) <= radius;
+}
+
+void VisibilityField::compute(const Tilemap &world, Vector2 origin, float rangePx)
+{
+    int tx, ty;
+    world.worldToTile(origin, tx, ty);
+    int r = std::max(1, (int)ceilf(rangePx / Tilemap::TILE_SIZE));
+    if (valid && tx == ox && ty == oy && r == radius && editVersion == world.getEditVersion())
+    {
+        stats.reused++;
+        return;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    ox = tx;
+    oy = ty;
+    radius = r;
+    side = 2 * r + 1;
+    editVersion = world.getEditVersion();
+    lit.assign((size_t)side * side, 0);
+    lit[(size_t)radius * side + radius] = 1; // the spot sees itself
+    for (int q = 0; q < 4; ++q)
+        scanQuadrant(world, q);
+    valid = true;
+
+    stats.computes++;
+    stats.tilesLastCompute = (int)std::count(lit.begin(), lit.end(), 1);
+    stats.msLastCompute = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void VisibilityField::scanQuadrant(const Tilemap &world, int quadrant)
+{
+    const int *q = QUAD[quadrant];
+
+    rows.clear();
+    rows.push_back({1, -1, 1, 1, 1});
+    while (!rows.empty())
+    {
+        Row row = rows.back();
+        rows.pop_back();
+        if (row.depth > radius)
+            continue;
+
+        // columns whose centres are inside the slopes, ties rounded inwards
+        const int d = row.depth;
+        int minCol = floorDiv(2 * d * row.startNum + row.startDen, 2 * row.startDen);
+        int maxCol = ceilDiv(2 * d * row.endNum - row.endDen, 2 * row.endDen);
+        minCol = std::max(minCol, -d);
+        maxCol = std::min(maxCol, d);
+
+        int prev = -1; // -1 nothing yet, 0 floor, 1 wall
+        int dx = q[0] * d + q[2] * minCol, dy = q[1] * d + q[3] * minCol;
+        for (int col = minCol; col <= maxCol; ++col, dx += q[2], dy += q[3])
+        {
+            bool wall = world.isWall(ox + dx, oy + dy);
+            // symmetric: a floor tile counts only if its centre is between the slopes
+            bool centreIn = col * row.startDen >= d * row.startNum && col * row.endDen <= d * row.endNum;
+            if (wall || centreIn)
+                lit[(size_t)(dy + radius) * side + (dx + radius)] = 1;
+
+            // slope through the tile's near left corner
+            const int sNum = 2 * col - 1, sDen = 2 * d;
+            if (prev == 1 && !wall)
+            {
+                row.startNum = sNum;
+                row.startDen = sDen;
+            }
+            if (prev == 0 && wall)
+                rows.push_back({d + 1, row.startNum, row.startDen, sNum, sDen});
+            prev = wall ? 1 : 0;
+        }
+        if (prev == 0)
+            rows.push_back({d + 1, row.startNum, row.startDen, row.endNum, row.endDen});
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <raylib.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+class Tilemap;
+
+/*
+Which tiles can see one spot (the player), worked out once a tick with symmetric
+shadowcasting (Albert Ford's version) instead of every hunter casting its own ray.
+Each of the four quadrants is scanned row by row outwards, walls narrow the slopes the
+next row is scanned between. A floor tile only counts when its centre is inside the lit
+slopes, which makes it symmetric: if the spot can see a tile that tile can see the spot,
+so "can this hunter see the player" is one lookup from the hunter's side.
+
+Walls that face the spot are marked visible too, for lighting. The field is a square of
+RADIUS tiles each side and is only redone when the spot moves to another tile, the radius
+changes or the map is carved.
+*/
+class VisibilityField
+{
+public:
+    struct Stats
+    {
+        long computes = 0;
+        long reused = 0;       // same tile, same map, nothing to do
+        int tilesLastCompute = 0;
+        double msLastCompute = 0.0;
+    };
+
+    // tiles around 'origin' that can see it, out to rangePx
+    void compute(const Tilemap &world, Vector2 origin, float rangePx);
+    void clear(); // new world (stats stay)
+
+    bool visible(const Tilemap &world, Vector2 p) const;
+    bool visibleTile(int tx, int ty) const
+    {
+        int lx = tx - ox + radius, ly = ty - oy + radius;
+        if (!valid || (unsigned)lx >= (unsigned)side || (unsigned)ly >= (unsigned)side)
+            return false;
+        return lit[(size_t)ly * side + lx] != 0;
+    }
+    bool ready() const { return valid; }
+    // true if the field is for origin's tile on this map (not carved since) and reaches 'from'
+    bool covers(const Tilemap &world, Vector2 origin, Vector2 from) const;
+    int originX() const { return ox; }
+    int originY() const { return oy; }
+    int radiusTiles() const { return radius; }
+
+    const Stats &getStats() const { return stats; }
+    size_t memoryBytes() const { return lit.capacity() + rows.capacity() * sizeof(Row); }
+
+private:
+    // a row of one quadrant between two slopes, start/end are fractions (den > 0)
+    struct Row
+    {
+        int depth;
+        int startNum, startDen;
+        int endNum, endDen;
+    };
+
+    bool valid = false;
+    int ox = 0, oy = 0, radius = 0, side = 0;
+    unsigned editVersion = 0;
+    std::vector<uint8_t> lit; // side*side around the origin
+    std::vector<Row> rows;    // scan stack, kept for its capacity
+    Stats stats;
+
+    void scanQuadrant(const Tilemap &world, int quadrant);
+};
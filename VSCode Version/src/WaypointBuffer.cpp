@@ -0,0 +1,32 @@
+#include "WaypointBuffer.hpp"
+#include "Tilemap.hpp"
+
+void WaypointBuffer::pull(const Tilemap &world, Vector2 start, const std::vector<Vector2> &tiles, float radius)
+{
+    count = 0;
+    cut = false;
+    const int n = (int)tiles.size();
+    Vector2 anchor = start;
+    // the tile path steps from centre to centre. from off centre the hop to the first tile can
+    // clip a corner it goes round, so walk back to the middle of our own tile first then
+    if (n > 0 && !world.hasWalkableLine(start, tiles[0], radius))
+    {
+        int tx, ty;
+        world.worldToTile(start, tx, ty);
+        anchor = world.tileToWorldCenter(tx, ty);
+        points[count++] = anchor;
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        // keep tile i only if the one after it can't be reached straight from the last corner
+        if (i + 1 < n && world.hasWalkableLine(anchor, tiles[i + 1], radius))
+            continue;
+        if (count == CAPACITY)
+        {
+            cut = true;
+            return;
+        }
+        points[count++] = tiles[i];
+        anchor = tiles[i];
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <raylib.h>
+#include <vector>
+
+class Tilemap;
+
+/*
+A hunter's path as corner points only, in a fixed array so repathing never allocates.
+pull() does string pulling over a tile by tile path: from each corner it keeps going while
+the hunter could still walk straight to the next tile (Tilemap::hasWalkableLine with its
+radius) and drops a corner on the last tile it could. Caves are mostly open, so that's
+usually a handful of points instead of one per tile. If the hunter can't go straight to the
+first tile from where it stands, the first corner is the centre of its own tile.
+
+A path with more than CAPACITY corners is cut short, the hunter walks to the last one and
+the next repath carries on from there.
+*/
+class WaypointBuffer
+{
+public:
+    static const int CAPACITY = 32;
+
+    // corners of 'tiles' as seen from 'start' (start itself isn't stored)
+    void pull(const Tilemap &world, Vector2 start, const std::vector<Vector2> &tiles, float radius);
+    void clear() { count = 0; }
+
+    int size() const { return count; }
+    bool truncated() const { return cut; }
+    const Vector2 &operator[](int i) const { return points[i]; }
+
+private:
+    Vector2 points[CAPACITY];
+    int count = 0;
+    bool cut = false;
+};
@@ -0,0 +1,139 @@
+#include "WorldPregen.hpp"
+#include <algorithm>
+#include <atomic>
+
+WorldPregen::WorldPregen(const WorldSpec &spec, unsigned firstSeed, int queueSize, int threads)
+    : spec(spec), queueSize(std::max(queueSize, 1)), seedRng(firstSeed)
+{
+    threads = std::max(threads, 1);
+    for (int i = 0; i < threads; ++i)
+        workers.emplace_back(&WorldPregen::workerLoop, this);
+}
+
+WorldPregen::~WorldPregen()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (auto &t : workers)
+        t.join();
+}
+
+void WorldPregen::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true)
+    {
+        wakeWorkers.wait(lock, [&]
+                         { return stopping || (int)ready.size() + inFlight < queueSize; });
+        if (stopping)
+            return;
+
+        unsigned seed = seedRng() % 100000 + 1;
+        inFlight++;
+        lock.unlock();
+
+        PreparedWorld w = buildWorld(spec, seed);
+
+        lock.lock();
+        inFlight--;
+        ready.push_back(std::move(w));
+        worldReady.notify_one();
+    }
+}
+
+bool WorldPregen::tryTake(PreparedWorld &out)
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (ready.empty())
+            return false;
+        out = std::move(ready.front());
+        ready.pop_front();
+    }
+    wakeWorkers.notify_one(); // room for another
+    return true;
+}
+
+PreparedWorld WorldPregen::take()
+{
+    PreparedWorld out;
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        worldReady.wait(lock, [&]
+                        { return !ready.empty(); });
+        out = std::move(ready.front());
+        ready.pop_front();
+    }
+    wakeWorkers.notify_one();
+    return out;
+}
+
+int WorldPregen::readyCount()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return (int)ready.size();
+}
+
+PreparedWorld WorldPregen::buildWorld(const WorldSpec &spec, unsigned seed)
+{
+    PreparedWorld w;
+    w.seed = seed;
+    w.map = Tilemap(spec.width, spec.height);
+    if (spec.noiseCave)
+        w.map.generateNoiseCave(seed, spec.noise, 1); // already on a worker, one thread each
+    else
+        w.map.generateCave(seed, spec.fillPercent, spec.smoothSteps);
+    w.playerSpawn = w.map.pickSpawnFloorNearCenter();
+
+    // spawn layout gets its own rng so the same seed always gives the same run
+    std::mt19937 rng(seed * 2654435761u + 1);
+
+    FloorQuery rule;
+    rule.from = w.playerSpawn;
+    rule.reachable = true;
+
+    rule.minDistTiles = spec.animalMinSpawnTiles;
+    w.animals.resize(spec.numAnimals);
+    for (auto &a : w.animals)
+        a.randomise(w.map, rng, rule);
+
+    // hunters start well away so the player gets a moment
+    rule.minDistTiles = spec.hunterMinSpawnTiles;
+    w.hunters.resize(spec.numHunters);
+    for (auto &h : w.hunters)
+    {
+        Vector2 p;
+        if (!w.map.randomFloorPosition(rng, rule, p))
+            p = w.map.randomFloorPosition(rng);
+        h.spawnAt(w.map, p, rng);
+    }
+
+    return w;
+}
+
+std::vector<PreparedWorld> WorldPregen::buildBatch(const WorldSpec &spec, const std::vector<unsigned> &seeds, int threads)
+{
+    std::vector<PreparedWorld> out(seeds.size());
+    if (threads <= 0)
+        threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<int>(threads, (int)seeds.size());
+
+    // workers pull the next seed index until the list runs out
+    std::atomic<size_t> next{0};
+    auto work = [&]()
+    {
+        for (size_t i = next++; i < seeds.size(); i = next++)
+            out[i] = buildWorld(spec, seeds[i]);
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t)
+        pool.emplace_back(work);
+    work();
+    for (auto &t : pool)
+        t.join();
+    return out;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "Tilemap.hpp"
+#include "Animal.hpp"
+#include "Hunter.hpp"
+
+// what a run needs from a cave
+struct WorldSpec
+{
+    int width = Tilemap::DEFAULT_WIDTH;
+    int height = Tilemap::DEFAULT_HEIGHT;
+    int fillPercent = 45;
+    int smoothSteps = 5;
+    bool noiseCave = false; // use the noise generator instead of fill + smoothing
+    NoiseCaveParams noise;
+    int numAnimals = 30;
+    int numHunters = 4;
+    // spawn distance from the player in tiles, everything spawns reachable from the player
+    float animalMinSpawnTiles = 3.0f;
+    float hunterMinSpawnTiles = 15.0f;
+};
+
+// a cave with everything spawned and hunters already holding their first patrol path
+struct PreparedWorld
+{
+    unsigned seed = 0;
+    Tilemap map;
+    Vector2 playerSpawn{};
+    std::vector<Animal> animals;
+    std::vector<Hunter> hunters;
+};
+
+/*
+Builds worlds on background threads so restarting never stalls the frame.
+Workers keep up to queueSize worlds ready, built from upcoming seeds; restart just takes one.
+Everything a worker touches is its own (map, rng, and findPath uses a per-thread Pathfinder),
+so no raylib calls happen off the main thread.
+*/
+class WorldPregen
+{
+public:
+    WorldPregen(const WorldSpec &spec, unsigned firstSeed, int queueSize = 2, int threads = 1);
+    ~WorldPregen();
+    WorldPregen(const WorldPregen &) = delete;
+    WorldPregen &operator=(const WorldPregen &) = delete;
+
+    bool tryTake(PreparedWorld &out); // false if nothing is ready yet
+    PreparedWorld take();             // waits for the next one
+    int readyCount();
+
+    // build one world on the calling thread
+    static PreparedWorld buildWorld(const WorldSpec &spec, unsigned seed);
+    // build a world per seed in parallel (threads 0 = one per hardware thread), results in seed order
+    static std::vector<PreparedWorld> buildBatch(const WorldSpec &spec, const std::vector<unsigned> &seeds, int threads = 0);
+
+private:
+    WorldSpec spec;
+    int queueSize;
+    std::mt19937 seedRng;
+
+    std::mutex mtx;
+    std::condition_variable wakeWorkers;
+    std::condition_variable worldReady;
+    std::deque<PreparedWorld> ready;
+    int inFlight = 0;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    void workerLoop();
+};
@@ -4,6 +4,12 @@
 #include "Boulder.hpp"
 #include "Hunter.hpp"
 #include "Combat.hpp"
+#include "WorldPregen.hpp"
+#include "PathScheduler.hpp"
+#include "FlowFieldService.hpp"
+#include "VisibilityField.hpp"
+#include "HunterPerception.hpp"
+#include "SpatialHash.hpp"
 #include <vector>
 #include <algorithm>
 #include <raymath.h>
@@ -40,8 +46,8 @@ SquadIntel squadIntel;
 // helper functions
 static Vector2 NearestBorderPoint(const Tilemap &world, Vector2 p)
 {
-    float worldW = Tilemap::WIDTH * Tilemap::TILE_SIZE;
-    float worldH = Tilemap::HEIGHT * Tilemap::TILE_SIZE;
+    float worldW = (float)world.getWidth() * Tilemap::TILE_SIZE;
+    float worldH = (float)world.getHeight() * Tilemap::TILE_SIZE;
 
     float dL = p.x;
     float dR = worldW - p.x;
@@ -82,8 +88,8 @@ static Vector2 NearestBorderPoint(const Tilemap &world, Vector2 p)
 // Scan the outer ring for any air and return its world center
 static bool FindBorderGap(const Tilemap &world, Vector2 &outPos)
 {
-    const int W = Tilemap::WIDTH;
-    const int H = Tilemap::HEIGHT;
+    const int W = world.getWidth();
+    const int H = world.getHeight();
     const int TS = Tilemap::TILE_SIZE;
 
     auto centerOf = [&](int tx, int ty)
@@ -178,32 +184,56 @@ int main()
     cam.offset = baseOffset;
     cam.zoom = 1.0f;
 
+    // worlds for the next runs are built in the background so restarting doesn't hitch
+    WorldSpec worldSpec;
+    worldSpec.numAnimals = NUM_ANIMALS;
+    worldSpec.numHunters = 4;
+    WorldPregen pregen(worldSpec, (unsigned)GetRandomValue(1, 100000), 2, 1);
+
+    // hunters queue their path searches here, about 1ms of A* a frame
+    PathScheduler pathScheduler;
+    pathScheduler.setBudget(1.0f, 20000);
+    // and hunters closing in on the player share flow fields instead of searching
+    FlowFieldService flowFields;
+    // and which tiles can see the player, worked out once a tick for all of them
+    VisibilityField playerSight;
+    // and what each of them can see, cone and all, in one pass
+    HunterPerception perception;
+    // who is near what, rebuilt each tick (entities only leave the vectors at the end of it)
+    SpatialHash animalHash, hunterHash;
+    std::vector<Mover> animalMoves; // kept for its capacity
+    bool showPathStats = false;
+
     // way to reset the game
     auto resetGame = [&]()
     {
-        // world
-        world = Tilemap{};
-        // world.generateCave(43, 45, 5);
-        world.generateCave(GetRandomValue(1, 100), 45, 5);
+        // world, normally already waiting in the queue
+        PreparedWorld next;
+        if (!pregen.tryTake(next))
+            next = WorldPregen::buildWorld(worldSpec, (unsigned)GetRandomValue(1, 100000));
+        world = std::move(next.map);
         world.setAllowBorderBreak(false);
 
         // player
-        monster.resetForNewRun(world.pickSpawnFloorNearCenter());
+        monster.resetForNewRun(next.playerSpawn);
 
         // animals
-        animals.clear();
-        animals.resize(NUM_ANIMALS);
-        for (auto &a : animals)
-            a.randomise(world);
-
-        // hunters
-        hunters.clear();
-        for (int i = 0; i < 4; i++)
+        animals = std::move(next.animals);
+
+        // hunters (already holding their first patrol path)
+        hunters = std::move(next.hunters);
+        pathScheduler.clear();
+        flowFields.clear();
+        playerSight.clear();
+        perception.clear();
+        for (int i = 0; i < (int)hunters.size(); ++i)
         {
-            Vector2 hpos = world.randomFloorPosition();
-            Hunter h;
-            h.spawnAt(world, hpos);
-            hunters.push_back(h);
+            hunters[i].id = i;
+            hunters[i].pathScheduler = &pathScheduler;
+            hunters[i].flowFields = &flowFields;
+            hunters[i].playerSight = &playerSight;
+            hunters[i].perception = &perception;
+            hunters[i].squadHash = &hunterHash;
         }
 
         // squad intel / projectiles / vfx
@@ -305,6 +335,10 @@ int main()
             continue; // skip gameplay when in menu
         }
 
+        // path scheduler debug line
+        if (IsKeyPressed(KEY_F3))
+            showPathStats = !showPathStats;
+
         // pause
         if (IsKeyPressed(KEY_P))
         {
@@ -338,8 +372,12 @@ int main()
             // camera target follows player
             cam.target = monster.getPosition();
 
+            // broadphase for this tick
+            animalHash.build(animals);
+            hunterHash.build(hunters);
+
             // player update
-            monster.update(dt, world, cam, animals, hunters);
+            monster.update(dt, world, cam, animals, hunters, animalHash, hunterHash);
 
             // camera shake
             if (shakeTime > 0.0f)
@@ -364,7 +402,7 @@ int main()
             // bite
             if (!monster.isTransforming() && !monster.isDashing())
             {
-                monster.tryBite(animals, hunters);
+                monster.tryBite(animals, hunters, animalHash, hunterHash);
             }
 
             // slam impact
@@ -391,15 +429,38 @@ int main()
             }
 
             // hunters
+            flowFields.beginTick();
+            // only worth it when someone is close enough to look, the others cast their own ray
+            {
+                Vector2 pp = monster.getPosition();
+                float range = 0.0f;
+                bool anyInRange = false;
+                for (const auto &h : hunters)
+                {
+                    if (!h.isAlive())
+                        continue;
+                    float r = fmaxf(h.sightRange, h.shootRange);
+                    float dx = h.pos.x - pp.x, dy = h.pos.y - pp.y;
+                    range = fmaxf(range, r);
+                    anyInRange = anyInRange || dx * dx + dy * dy <= r * r;
+                }
+                if (anyInRange)
+                    playerSight.compute(world, pp, range);
+                perception.update(world, hunters, pp, &playerSight);
+            }
             for (int i = 0; i < (int)hunters.size(); ++i)
             {
                 auto &h = hunters[i];
                 if (!h.isAlive())
                     continue;
                 h.update(dt, world, monster, squadIntel);
+                hunterHash.move(i, h.pos);
                 h.tryShoot(dt, world, monster, hunters, i, bullets);
             }
 
+            // searches the hunters asked for, they pick them up next tick
+            pathScheduler.update(world);
+
             // bullets
             for (auto &b : bullets)
                 b.update(dt, world);
@@ -433,18 +494,16 @@ int main()
                 }
                 else
                 {
-                    for (auto &h : hunters)
+                    // first in squad order, like the old scan
+                    int hit = -1;
+                    hunterHash.circle(b.pos, b.radius, [&](int i)
+                                      {
+                        if (hunters[i].isAlive() && (hit < 0 || i < hit))
+                            hit = i; });
+                    if (hit >= 0)
                     {
-                        if (!h.isAlive())
-                            continue;
-                        float dx = h.pos.x - b.pos.x, dy = h.pos.y - b.pos.y;
-                        float rr = (h.radius + b.radius);
-                        if (dx * dx + dy * dy <= rr * rr)
-                        {
-                            h.takeDamage(b.damage);
-                            b.alive = false;
-                            break;
-                        }
+                        hunters[hit].takeDamage(b.damage);
+                        b.alive = false;
                     }
                 }
             }
@@ -455,55 +514,43 @@ int main()
                                          { return !b.alive; }),
                           bullets.end());
 
-            // cleanup hunters
-            hunters.erase(std::remove_if(hunters.begin(), hunters.end(),
-                                         [](const Hunter &h)
-                                         { return !h.isAlive(); }),
-                          hunters.end());
-
-            // animals
-            for (auto &a : animals)
-                a.update(dt, world);
-            animals.erase(std::remove_if(animals.begin(), animals.end(),
-                                         [](const Animal &a)
-                                         { return !a.alive; }),
-                          animals.end());
+            // animals, all their moves resolved against the walls in one go
+            animalMoves.resize(animals.size());
+            for (int i = 0; i < (int)animals.size(); ++i)
+                animalMoves[i] = {animals[i].pos, animals[i].radius, animals[i].steer(dt)};
+            world.resolveCollisions(animalMoves.data(), (int)animalMoves.size());
+            for (int i = 0; i < (int)animals.size(); ++i)
+            {
+                animals[i].pos = animalMoves[i].pos;
+                if (animalMoves[i].blocked)
+                    animals[i].hitWall();
+                animalHash.move(i, animals[i].pos);
+            }
 
             // boulders
             for (auto &b : boulders)
             {
-                bool exploded = b.update(dt, world, animals, hunters, monster);
+                bool exploded = b.update(dt, world, animals, hunters, monster, animalHash, hunterHash);
                 if (exploded)
                 {
-                    // indent map
-                    world.carveCircle(b.pos, 50.0f, true, nullptr);
-
-                    if (phase == GamePhase::Escape)
-                    {
-                        world.carveCircle(b.pos, 48.0f, false, nullptr);
-                    }
+                    // indent map, in the escape phase it can break the border too
+                    CarveStamp crater[2] = {{b.pos, 50.0f, true}, {b.pos, 48.0f, false}};
+                    world.carveCircles(crater, (phase == GamePhase::Escape) ? 2 : 1);
 
                     // animal AoE
                     float aoe = 64.0f;
-                    for (auto &a : animals)
-                    {
-                        if (!a.alive)
-                            continue;
+                    animalHash.circle(b.pos, aoe, [&](int i)
+                                      {
+                        Animal &a = animals[i];
                         float dx = a.pos.x - b.pos.x, dy = a.pos.y - b.pos.y;
                         if (dx * dx + dy * dy <= aoe * aoe)
-                            a.alive = false;
-                    }
+                            a.alive = false; });
 
                     // hunter AoE
-                    for (auto &h : hunters)
-                    {
-                        float dx = h.pos.x - b.pos.x, dy = h.pos.y - b.pos.y;
-                        float rr = (b.radius + h.radius);
-                        if (dx * dx + dy * dy <= rr * rr)
-                        {
-                            h.applyHit(monster.boulderAoeDamage(), b.pos, 180.0f);
-                        }
-                    }
+                    hunterHash.circle(b.pos, b.radius, [&](int i)
+                                      {
+                        if (hunters[i].isAlive())
+                            hunters[i].applyHit(monster.boulderAoeDamage(), b.pos, 180.0f); });
 
                     impacts.push_back({b.pos, 0.2f, 0.0f});
                     shakeDuration = 0.15f;
@@ -516,6 +563,19 @@ int main()
                                           { return !b.alive; }),
                            boulders.end());
 
+            // cleanup, last so the hashes' indices held all tick
+            for (auto &h : hunters)
+                if (!h.isAlive())
+                    pathScheduler.cancel(h.id);
+            hunters.erase(std::remove_if(hunters.begin(), hunters.end(),
+                                         [](const Hunter &h)
+                                         { return !h.isAlive(); }),
+                          hunters.end());
+            animals.erase(std::remove_if(animals.begin(), animals.end(),
+                                         [](const Animal &a)
+                                         { return !a.alive; }),
+                          animals.end());
+
             // impacts
             for (auto &fx : impacts)
                 fx.elapsed += dt;
@@ -629,7 +689,12 @@ int main()
         ClearBackground(Color{12, 30, 28, 255});
 
         BeginMode2D(cam);
-        world.draw();
+        {
+            // only draw tiles on screen
+            Vector2 tl = GetScreenToWorld2D({0, 0}, cam);
+            Vector2 br = GetScreenToWorld2D({(float)screenW, (float)screenH}, cam);
+            world.draw(Rectangle{tl.x, tl.y, br.x - tl.x, br.y - tl.y});
+        }
         for (auto &a : animals)
             a.draw();
         for (auto &b : boulders)
@@ -735,6 +800,27 @@ int main()
 
         // Stage/food
         DrawText(TextFormat("Stage: %d", monster.getStage()), hudX, hudY, 22, WHITE);
+
+        if (showPathStats)
+        {
+            const PathScheduler::Stats &ps = pathScheduler.getStats();
+            DrawText(TextFormat("paths: queue %d (max %d)  %d searches %d nodes %.2f ms  latency avg %.1f max %.1f ms",
+                                ps.queueDepth, ps.maxQueueDepth, ps.searchesLastTick, ps.nodesLastTick, ps.msLastTick,
+                                ps.avgLatencyMs, ps.maxLatencyMs),
+                     hudX, GetScreenHeight() - 30, 18, WHITE);
+            const FlowFieldService::Stats &fs = flowFields.getStats();
+            DrawText(TextFormat("flow: %d built %d lookups %.2f ms  (%ld fields total)", fs.fieldsBuiltLastTick,
+                                fs.lookupsLastTick, fs.msLastTick, fs.fieldsBuilt),
+                     hudX, GetScreenHeight() - 52, 18, WHITE);
+            const VisibilityField::Stats &vs = playerSight.getStats();
+            DrawText(TextFormat("sight: %d tiles %.2f ms  (%ld computed, %ld reused)", vs.tilesLastCompute,
+                                vs.msLastCompute, vs.computes, vs.reused),
+                     hudX, GetScreenHeight() - 74, 18, WHITE);
+            const HunterPerception::Stats &hs = perception.getStats();
+            DrawText(TextFormat("perception: %d hunters  %d in range  %d in cone  %d rays  %.3f ms", hs.hunters,
+                                hs.inRange, hs.inCone, hs.rays, hs.msLastTick),
+                     hudX, GetScreenHeight() - 96, 18, WHITE);
+        }
         if (monster.getStage() < 4) {
             DrawText(TextFormat("Food: %d / %d", monster.getFood(), monster.getStageFoodCost()), hudX, hudY + 24, 20, WHITE);
         }